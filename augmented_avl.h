@@ -0,0 +1,243 @@
+#ifndef AUGMENTED_AVL_H
+#define AUGMENTED_AVL_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include "avlbst.h"
+
+/**
+* Aggregate policies for AugmentedAVLTree. A policy names the aggregate type and gives
+* its identity, the aggregate of a single value (lift) and an associative combine,
+* where combine(a, b) aggregates a range a followed by a range b. combine does not
+* have to be commutative.
+*/
+template <typename Value>
+struct SumAggregate
+{
+    typedef Value type;
+    static type identity() { return Value(); }
+    static type lift(const Value& value) { return value; }
+    static type combine(const type& a, const type& b) { return a + b; }
+};
+
+template <typename Value>
+struct MinAggregate
+{
+    typedef Value type;
+    static type identity() { return std::numeric_limits<Value>::max(); }
+    static type lift(const Value& value) { return value; }
+    static type combine(const type& a, const type& b) { return std::min(a, b); }
+};
+
+template <typename Value>
+struct MaxAggregate
+{
+    typedef Value type;
+    static type identity() { return std::numeric_limits<Value>::lowest(); }
+    static type lift(const Value& value) { return value; }
+    static type combine(const type& a, const type& b) { return std::max(a, b); }
+};
+
+template <typename Value>
+struct CountAggregate
+{
+    typedef uint64_t type;
+    static type identity() { return 0; }
+    static type lift(const Value&) { return 1; }
+    static type combine(const type& a, const type& b) { return a + b; }
+};
+
+/**
+* An AVLNode that also holds the aggregate of the values in its subtree.
+*/
+template <typename Key, typename Value, typename Aggregate>
+class AugmentedAVLNode : public AVLNode<Key, Value>
+{
+public:
+    AugmentedAVLNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent);
+
+    const typename Aggregate::type& getAggregate() const;
+    void setAggregate(const typename Aggregate::type& aggregate);
+
+protected:
+    typename Aggregate::type aggregate_;
+};
+
+template<class Key, class Value, class Aggregate>
+AugmentedAVLNode<Key, Value, Aggregate>::AugmentedAVLNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent) :
+    AVLNode<Key, Value>(key, value, parent), aggregate_(Aggregate::lift(value))
+{
+
+}
+
+template<class Key, class Value, class Aggregate>
+const typename Aggregate::type& AugmentedAVLNode<Key, Value, Aggregate>::getAggregate() const
+{
+    return aggregate_;
+}
+
+template<class Key, class Value, class Aggregate>
+void AugmentedAVLNode<Key, Value, Aggregate>::setAggregate(const typename Aggregate::type& aggregate)
+{
+    aggregate_ = aggregate;
+}
+
+/**
+* An AVLTree whose nodes keep the aggregate of their subtree's values under the
+* Aggregate policy, so that aggregate(lo, hi) folds any key range in O(log n).
+*
+* The aggregates are kept up to date by insert(), setValue(), remove() and the
+* rotations, through AVLTree's augmentation hooks; each recomputes one root path. A
+* value written in place could not be seen, so the non-const operator[] is hidden, and
+* a value an iterator points at must be changed through setValue(), not it->second.
+*/
+template <typename Key, typename Value, typename Aggregate>
+class AugmentedAVLTree : public AVLTree<Key, Value>
+{
+public:
+    typedef typename Aggregate::type aggregate_type;
+    typedef typename AVLTree<Key, Value>::iterator iterator;
+
+    // combines the values of the keys in [lo, hi], in key order
+    aggregate_type aggregate(const Key& lo, const Key& hi) const;
+    // combines every value in the tree
+    aggregate_type aggregate() const;
+
+    // sets the value it points at and recomputes the aggregates above it, in O(log n)
+    // without searching for the key again
+    void setValue(iterator it, const Value& value);
+
+    using BinarySearchTree<Key, Value>::operator[];
+
+private:
+    // not defined: a write through the returned reference would skip the aggregates
+    Value& operator[](const Key& key);
+
+protected:
+    typedef AugmentedAVLNode<Key, Value, Aggregate> AugNode;
+
+    virtual AVLNode<Key, Value>* makeNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent) override;
+    virtual void pullUp(AVLNode<Key, Value>* n) override;
+    virtual void pullUpPath(AVLNode<Key, Value>* n) override;
+    virtual void nodeSwap(AVLNode<Key, Value>* n1, AVLNode<Key, Value>* n2) override;
+
+    static aggregate_type aggregateOf(const Node<Key, Value>* n);
+};
+
+/*
+  ------------------------------------------------------
+  Begin implementations for the AugmentedAVLTree class.
+  ------------------------------------------------------
+*/
+
+/**
+* Finds the highest node inside [lo, hi], then follows the range's two boundaries
+* down from it, taking whole subtrees that lie inside the range from the aggregates
+* stored in them.
+*/
+template<class Key, class Value, class Aggregate>
+typename AugmentedAVLTree<Key, Value, Aggregate>::aggregate_type
+AugmentedAVLTree<Key, Value, Aggregate>::aggregate(const Key& lo, const Key& hi) const
+{
+    const Node<Key, Value>* top = this->root_;
+    while(top != NULL)
+    {
+        if(top->getKey() < lo) top = top->getRight();
+        else if(hi < top->getKey()) top = top->getLeft();
+        else break;
+    }
+    if(top == NULL) return Aggregate::identity();
+
+    // each step to the left lands below everything taken so far
+    aggregate_type left = Aggregate::identity();
+    for(const Node<Key, Value>* n = top->getLeft(); n != NULL; )
+    {
+        if(n->getKey() < lo) n = n->getRight();
+        else
+        {
+            left = Aggregate::combine(Aggregate::combine(Aggregate::lift(n->getValue()), aggregateOf(n->getRight())), left);
+            n = n->getLeft();
+        }
+    }
+
+    aggregate_type right = Aggregate::identity();
+    for(const Node<Key, Value>* n = top->getRight(); n != NULL; )
+    {
+        if(hi < n->getKey()) n = n->getLeft();
+        else
+        {
+            right = Aggregate::combine(right, Aggregate::combine(aggregateOf(n->getLeft()), Aggregate::lift(n->getValue())));
+            n = n->getRight();
+        }
+    }
+
+    return Aggregate::combine(left, Aggregate::combine(Aggregate::lift(top->getValue()), right));
+}
+
+template<class Key, class Value, class Aggregate>
+typename AugmentedAVLTree<Key, Value, Aggregate>::aggregate_type
+AugmentedAVLTree<Key, Value, Aggregate>::aggregate() const
+{
+    return aggregateOf(this->root_);
+}
+
+template<class Key, class Value, class Aggregate>
+void AugmentedAVLTree<Key, Value, Aggregate>::setValue(iterator it, const Value& value)
+{
+    AVLNode<Key, Value>* n = static_cast<AVLNode<Key, Value>*>(this->iteratorNode(it));
+    n->setValue(value);
+    pullUpPath(n);
+}
+
+template<class Key, class Value, class Aggregate>
+AVLNode<Key, Value>* AugmentedAVLTree<Key, Value, Aggregate>::makeNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent)
+{
+    return new AugNode(key, value, parent);
+}
+
+template<class Key, class Value, class Aggregate>
+void AugmentedAVLTree<Key, Value, Aggregate>::pullUp(AVLNode<Key, Value>* n)
+{
+    static_cast<AugNode*>(n)->setAggregate(Aggregate::combine(aggregateOf(n->getLeft()),
+        Aggregate::combine(Aggregate::lift(n->getValue()), aggregateOf(n->getRight()))));
+}
+
+template<class Key, class Value, class Aggregate>
+void AugmentedAVLTree<Key, Value, Aggregate>::pullUpPath(AVLNode<Key, Value>* n)
+{
+    for(; n != NULL; n = n->getParent())
+        pullUp(n);
+}
+
+/**
+* Swaps the aggregates along with the nodes, so the upper position keeps its own (its
+* subtree holds the same values); remove() recomputes the path from the lower one.
+*/
+template<class Key, class Value, class Aggregate>
+void AugmentedAVLTree<Key, Value, Aggregate>::nodeSwap(AVLNode<Key, Value>* n1, AVLNode<Key, Value>* n2)
+{
+    AVLTree<Key, Value>::nodeSwap(n1, n2);
+    aggregate_type temp = static_cast<AugNode*>(n1)->getAggregate();
+    static_cast<AugNode*>(n1)->setAggregate(static_cast<AugNode*>(n2)->getAggregate());
+    static_cast<AugNode*>(n2)->setAggregate(temp);
+}
+
+template<class Key, class Value, class Aggregate>
+typename AugmentedAVLTree<Key, Value, Aggregate>::aggregate_type
+AugmentedAVLTree<Key, Value, Aggregate>::aggregateOf(const Node<Key, Value>* n)
+{
+    if(n == NULL) return Aggregate::identity();
+    return static_cast<const AugNode*>(n)->getAggregate();
+}
+
+/*
+  ------------------------------------------------------
+  End implementations for the AugmentedAVLTree class.
+  ------------------------------------------------------
+*/
+
+#endif
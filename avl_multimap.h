@@ -0,0 +1,238 @@
+#ifndef AVL_MULTIMAP_H
+#define AVL_MULTIMAP_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+#include <vector>
+#include "avlbst.h"
+
+/**
+* An AVLTree that keeps every inserted pair, equal keys included, each in a node of its
+* own. A new pair goes after every pair already there with the same key, so iterating
+* an equal range yields its values in insertion order, and removals keep that order.
+*
+* count() and equal_range() take O(log n + k) for k equal keys, erase() O(log n) and
+* remove() O(k log n). find() and operator[] reach the first pair with the key.
+* Iterators stay valid until their own pair is erased. insertBatch(), eraseBatch() and
+* buildParallel() are redone with the same rules: every pair is kept, and a batch's
+* pairs with one key follow each other in batch order. AVLTree's hinted insert is
+* hidden by insert(). Through an AVLTree reference the batch and build calls are
+* AVLTree's, which overwrite equal keys.
+*/
+template <typename Key, typename Value>
+class AVLMultiMap : public AVLTree<Key, Value>
+{
+public:
+    typedef typename AVLTree<Key, Value>::iterator iterator;
+
+    virtual void insert(const std::pair<const Key, Value>& keyValuePair) override;
+    // removes every pair with the key
+    virtual void remove(const Key& key) override;
+    // removes the one pair at it and returns an iterator to the pair after it
+    iterator erase(iterator it);
+
+    size_t count(const Key& key) const;
+    std::pair<iterator, iterator> equal_range(const Key& key) const;
+
+    iterator find(const Key& key) const;
+    Value& operator[](const Key& key);
+    Value const & operator[](const Key& key) const;
+
+    // insert() or remove() for each pair or key in turn; AVLTree's versions would
+    // overwrite equal keys and keep only the last of a batch's repeats
+    template<typename InputIt> void insertBatch(InputIt first, InputIt last);
+    template<typename InputIt> void eraseBatch(InputIt first, InputIt last);
+    // Loads an unsorted range of pairs, every one of them, as AVLTree::buildParallel()
+    // does; into a tree that already holds entries the pairs are added as
+    // insertBatch() would.
+    template<typename InputIt> void buildParallel(InputIt first, InputIt last, unsigned threads = 0);
+
+protected:
+    // first node whose key is not below key (or above it, if after is set)
+    AVLNode<Key, Value>* bound(const Key& key, bool after) const;
+};
+
+/*
+  -------------------------------------------------
+  Begin implementations for the AVLMultiMap class.
+  -------------------------------------------------
+*/
+
+/**
+* Walks right past equal keys, so the new node lands after all of them.
+*/
+template<class Key, class Value>
+void AVLMultiMap<Key, Value>::insert(const std::pair<const Key, Value>& keyValuePair)
+{
+    BST_STATS_OP(TREE_OP_INSERT);
+    if(this->trace_ != NULL) this->trace_->record(TRACE_INSERT, keyValuePair.first);
+    const Key& key = keyValuePair.first;
+    if(this->root_ == NULL)
+    {
+        this->linkNode(NULL, key, keyValuePair.second);
+        return;
+    }
+
+    AVLNode<Key, Value>* parent = this->AVLroot_;
+    int depth = 1;
+    while(true)
+    {
+        BST_STATS_VISIT();
+        BST_STATS_COMPARE(1);
+        AVLNode<Key, Value>* next = key < parent->getKey() ? parent->getLeft() : parent->getRight();
+        if(next == NULL) break;
+        parent = next;
+        ++depth;
+    }
+    BST_STATS_DEPTH(depth + 1);
+
+    this->linkNode(parent, key, keyValuePair.second);
+}
+
+template<class Key, class Value>
+void AVLMultiMap<Key, Value>::remove(const Key& key)
+{
+    BST_STATS_OP(TREE_OP_REMOVE);
+    if(this->trace_ != NULL) this->trace_->record(TRACE_REMOVE, key);
+    AVLNode<Key, Value>* n = bound(key, false);
+    while(n != NULL && !(key < n->getKey()))
+    {
+        AVLNode<Key, Value>* next = this->nextNode(n);
+        this->removeNode(n);
+        n = next;
+    }
+}
+
+template<class Key, class Value>
+typename AVLMultiMap<Key, Value>::iterator AVLMultiMap<Key, Value>::erase(iterator it)
+{
+    Node<Key, Value>* n = BinarySearchTree<Key, Value>::iteratorNode(it);
+    if(n == NULL) return it;
+    BST_STATS_OP(TREE_OP_REMOVE);
+    if(this->trace_ != NULL) this->trace_->record(TRACE_REMOVE, n->getKey());
+    Node<Key, Value>* next = this->nextNode(n);
+    this->removeNode(static_cast<AVLNode<Key, Value>*>(n));
+    return this->iteratorAt(next);
+}
+
+template<class Key, class Value>
+size_t AVLMultiMap<Key, Value>::count(const Key& key) const
+{
+    size_t total = 0;
+    AVLNode<Key, Value>* last = bound(key, true);
+    for(Node<Key, Value>* n = bound(key, false); n != last; n = this->nextNode(n))
+        total++;
+    return total;
+}
+
+template<class Key, class Value>
+std::pair<typename AVLMultiMap<Key, Value>::iterator, typename AVLMultiMap<Key, Value>::iterator>
+AVLMultiMap<Key, Value>::equal_range(const Key& key) const
+{
+    return std::make_pair(this->iteratorAt(bound(key, false)), this->iteratorAt(bound(key, true)));
+}
+
+template<class Key, class Value>
+typename AVLMultiMap<Key, Value>::iterator AVLMultiMap<Key, Value>::find(const Key& key) const
+{
+    BST_STATS_OP(TREE_OP_FIND);
+    if(this->trace_ != NULL) this->trace_->record(TRACE_FIND, key);
+    AVLNode<Key, Value>* n = bound(key, false);
+    if(n != NULL && key < n->getKey()) n = NULL;
+    return this->iteratorAt(n);
+}
+
+template<class Key, class Value>
+Value& AVLMultiMap<Key, Value>::operator[](const Key& key)
+{
+    BST_STATS_OP(TREE_OP_FIND);
+    if(this->trace_ != NULL) this->trace_->record(TRACE_FIND, key);
+    AVLNode<Key, Value>* n = bound(key, false);
+    if(n == NULL || key < n->getKey()) throw std::out_of_range("Invalid key");
+    return n->getValue();
+}
+
+template<class Key, class Value>
+Value const & AVLMultiMap<Key, Value>::operator[](const Key& key) const
+{
+    BST_STATS_OP(TREE_OP_FIND);
+    if(this->trace_ != NULL) this->trace_->record(TRACE_FIND, key);
+    AVLNode<Key, Value>* n = bound(key, false);
+    if(n == NULL || key < n->getKey()) throw std::out_of_range("Invalid key");
+    return n->getValue();
+}
+
+template<class Key, class Value>
+template<typename InputIt>
+void AVLMultiMap<Key, Value>::insertBatch(InputIt first, InputIt last)
+{
+    for(; first != last; ++first) insert(*first);
+}
+
+template<class Key, class Value>
+template<typename InputIt>
+void AVLMultiMap<Key, Value>::eraseBatch(InputIt first, InputIt last)
+{
+    for(; first != last; ++first) remove(*first);
+}
+
+/**
+* The sort is stable and nothing is dropped, so equal keys keep their batch order; the
+* balanced build only needs the pairs in key order, repeats or not.
+*/
+template<class Key, class Value>
+template<typename InputIt>
+void AVLMultiMap<Key, Value>::buildParallel(InputIt first, InputIt last, unsigned threads)
+{
+    if(this->root_ != NULL)
+    {
+        insertBatch(first, last);
+        return;
+    }
+
+    std::vector<std::pair<Key, Value> > batch(first, last);
+    WorkStealingPool pool(threads);
+    typename AVLTree<Key, Value>::BatchKeyLess less;
+    if(!std::is_sorted(batch.begin(), batch.end(), less))
+        parallelStableSort(batch, less, pool);
+    if(this->trace_ != NULL)
+    {
+        for(size_t i = 0; i < batch.size(); i++) this->trace_->record(TRACE_INSERT, batch[i].first);
+    }
+    this->buildSorted(batch, pool);
+}
+
+template<class Key, class Value>
+AVLNode<Key, Value>* AVLMultiMap<Key, Value>::bound(const Key& key, bool after) const
+{
+    if(this->root_ == NULL) return NULL;
+    AVLNode<Key, Value>* found = NULL;
+    AVLNode<Key, Value>* n = this->AVLroot_;
+    while(n != NULL)
+    {
+        BST_STATS_VISIT();
+        BST_STATS_COMPARE(1);
+        if(after ? key < n->getKey() : !(n->getKey() < key))
+        {
+            found = n;
+            n = n->getLeft();
+        }
+        else
+        {
+            n = n->getRight();
+        }
+    }
+    return found;
+}
+
+/*
+  -------------------------------------------------
+  End implementations for the AVLMultiMap class.
+  -------------------------------------------------
+*/
+
+#endif
@@ -6,6 +6,8 @@
 #include <cstdlib>
 #include <cstdint>
 #include <algorithm>
+#include <vector>
+#include <utility>
 #include "bst.h"
 
 struct KeyError { };
@@ -131,23 +133,132 @@ template <class Key, class Value>
 class AVLTree : public BinarySearchTree<Key, Value>
 {
 public:
+    typedef typename BinarySearchTree<Key, Value>::iterator iterator;
+
     virtual void insert (const std::pair<const Key, Value> &new_item); // TODO
     virtual void remove(const Key& key);  // TODO
+    // Insert (or update) next to hint when the key belongs there, just before or just
+    // after it, and return an iterator to the pair. That takes the step from hint to
+    // its neighbour and amortized O(1) rebalancing; keys past the current maximum are
+    // O(1) amortized whatever the hint. Otherwise the search starts from hint.
+    iterator insert(iterator hint, const std::pair<const Key, Value>& new_item);
+    // Insert (or update) and remove a whole batch of pairs or keys in key order, each
+    // search starting from where the previous one ended; unsorted batches are sorted
+    // first, and where a batch repeats a key the last pair wins.
+    template<typename InputIt> void insertBatch(InputIt first, InputIt last);
+    template<typename InputIt> void eraseBatch(InputIt first, InputIt last);
+    // Loads an unsorted range of pairs using threads threads (0 for one per hardware
+    // thread): sorts it, keeps the last pair for each key and builds a perfectly
+    // balanced tree, subtrees in parallel. Into a tree that already holds entries the
+    // pairs are merged as insertBatch() would.
+    template<typename InputIt> void buildParallel(InputIt first, InputIt last, unsigned threads = 0);
+    // The hinted insert, the batches and buildParallel() are not virtual and link nodes
+    // themselves, so made through an AVLTree reference they skip whatever a subclass
+    // does in its own insert() and remove(). AVLMultiMap, BufferedAVLTree and
+    // DurableAVLTree redeclare them or hide them behind their own insert(); call those
+    // through the subclass's type.
+    virtual void clear() override;
+
+    /**
+    * A finger into the tree for lookups that land near each other: each seek() starts
+    * where the last one ended instead of at the root.
+    */
+    class Cursor
+    {
+    public:
+        Cursor();
+
+        // An iterator to key's pair, or end() if key is missing; either way the cursor
+        // moves to where the search ended.
+        iterator seek(const Key& key);
+
+    protected:
+        friend class AVLTree<Key, Value>;
+        Cursor(const AVLTree<Key, Value>* tree);
+        const AVLTree<Key, Value>* tree_;
+        AVLNode<Key, Value>* node_;
+        // the tree's epoch_ when node_ was found
+        unsigned long epoch_;
+    };
+
+    // A cursor on this tree, starting at the root.
+    Cursor cursor() const;
 		// void debugTime()
 		// {
 		// 	debug = !debug;
 		// };
 protected:
     virtual void nodeSwap( AVLNode<Key,Value>* n1, AVLNode<Key,Value>* n2);
+    void removeNode(AVLNode<Key, Value>* to_remove);
 
     // Add helper functions here
 		AVLNode<Key, Value>* AVLroot_ = NULL;
+    // the node with the largest key; only meaningful while root_ is not NULL
+    AVLNode<Key, Value>* rightmost_ = NULL;
+    // bumped whenever nodes are deleted, so cursors know their node may be gone;
+    // rotations and inserts leave every node in place
+    unsigned long epoch_ = 0;
     void rotateLeft(AVLNode<Key, Value>* n);
     void rotateRight(AVLNode<Key, Value>* n);
-    void setTreeBalance(AVLNode<Key, Value>* n);
-    void checkBalance(AVLNode<Key, Value>* n);
-    void fixBalance(AVLNode<Key, Value>* n);
+    // virtual so WAVLTree can rebalance by rank instead (see wavlbst.h)
+    virtual void insertFix(AVLNode<Key, Value>* n);
+    virtual void removeFix(AVLNode<Key, Value>* n, int8_t diff);
+    AVLNode<Key, Value>* fixBalance(AVLNode<Key, Value>* n);
+    virtual bool nodeBalance(const Node<Key, Value>* n, int& balance) const override;
+    // augmentation hooks, no-ops here (see augmented_avl.h): makeNode allocates every
+    // node, pullUp recomputes n from its children after a rotation, and pullUpPath
+    // does that from n up to the root once n's subtree has changed
+    virtual AVLNode<Key, Value>* makeNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent);
+    virtual void pullUp(AVLNode<Key, Value>* n);
+    virtual void pullUpPath(AVLNode<Key, Value>* n);
 		AVLNode<Key,Value>* internalFind(const Key& key) const;
+    // hangs a new node for key from parent (or makes it the root if parent is NULL),
+    // keeps rightmost_, and rebalances; parent must be where a search for key ended
+    AVLNode<Key, Value>* linkNode(AVLNode<Key, Value>* parent, const Key& key, const Value& value);
+    // key's node, or the node it would hang from, searching up and then down from
+    // finger (the root if NULL)
+    AVLNode<Key, Value>* descendFrom(AVLNode<Key, Value>* finger, const Key& key) const;
+    // key's node, or the node it would hang from, if key is n's or belongs right next
+    // to n in key order; NULL otherwise
+    AVLNode<Key, Value>* hintParent(AVLNode<Key, Value>* n, const Key& key) const;
+    // n's in-order successor and predecessor anywhere in the tree; iterator++ would
+    // also be traced
+    static AVLNode<Key, Value>* nextNode(Node<Key, Value>* n);
+    static AVLNode<Key, Value>* prevNode(Node<Key, Value>* n);
+    // insertBatch() and eraseBatch() once the batch is sorted
+    void insertSorted(const std::vector<std::pair<Key, Value> >& batch);
+    void eraseSorted(const std::vector<Key>& batch);
+    // orders insertBatch() pairs by key alone, so stable_sort keeps repeats in order
+    struct BatchKeyLess
+    {
+        bool operator()(const std::pair<Key, Value>& a, const std::pair<Key, Value>& b) const { return a.first < b.first; }
+    };
+    // sets the balance of a node built bottom-up whose subtrees have the given heights;
+    // virtual so WAVLTree can store rank differences instead
+    virtual void setChildHeights(AVLNode<Key, Value>* n, int leftHeight, int rightHeight);
+    // buildParallel()'s work on a sorted batch, whose keys repeat only for AVLMultiMap:
+    // batch[lo, hi) is built into a subtree hung from parent on side (0 left, 1 right,
+    // parent NULL for the root)
+    struct BuildRange
+    {
+        size_t lo;
+        size_t hi;
+        AVLNode<Key, Value>* parent;
+        int side;
+    };
+    struct BuildTask
+    {
+        AVLTree<Key, Value>* tree;
+        const std::vector<std::pair<Key, Value> >* batch;
+        const std::vector<BuildRange>* ranges;
+
+        void operator()(size_t i, unsigned) { tree->buildSubtree(*batch, (*ranges)[i]); }
+    };
+    void buildSorted(const std::vector<std::pair<Key, Value> >& batch, WorkStealingPool& pool);
+    void buildSubtree(const std::vector<std::pair<Key, Value> >& batch, const BuildRange& range);
+    AVLNode<Key, Value>* buildNode(const std::vector<std::pair<Key, Value> >& batch, const BuildRange& range);
+    // height of a subtree built from size sorted pairs
+    static int builtHeight(size_t size);
 		// bool debug = false;
 };
 
@@ -166,12 +277,21 @@ void AVLTree<Key, Value>::insert (const std::pair<const Key, Value> &new_item)
 		// if(debug)
 		// 	BinarySearchTree<Key, Value>::print();
 		
-			
+		BST_STATS_OP(TREE_OP_INSERT);
+		if(this->trace_!=NULL) this->trace_->record(TRACE_INSERT, new_item.first);
 		if(BinarySearchTree<Key,Value>::root_ == NULL)
 		{
-			AVLroot_ = new AVLNode<Key, Value>(new_item.first, new_item.second, NULL);
-			BinarySearchTree<Key,Value>::root_ = AVLroot_;
-			AVLroot_->setBalance(0);
+			linkNode(NULL, new_item.first, new_item.second);
+			return;
+		}
+
+		// past the maximum: hang it off the rightmost node without searching, and the
+		// rebalancing only retraces the right spine
+		BST_STATS_VISIT();
+		BST_STATS_COMPARE(1);
+		if(rightmost_->getKey() < new_item.first)
+		{
+			linkNode(rightmost_, new_item.first, new_item.second);
 			return;
 		}
 
@@ -180,16 +300,19 @@ void AVLTree<Key, Value>::insert (const std::pair<const Key, Value> &new_item)
 		if(temp!=NULL)
 		{
 			temp->setValue(new_item.second);
+			pullUpPath(temp);
 			// if(debug)
 			// std::cout << "Updated value" << std::endl;
 			return;
 		}
 
 		temp = AVLroot_;
+		int depth = 1;
 		while(temp->getLeft()!=NULL || temp->getRight()!=NULL)
 		{
 			// need to enter left subtree
-
+			BST_STATS_VISIT();
+			BST_STATS_COMPARE(1);
 			if(temp->getKey()>new_item.first)
 			{
 				if(temp->getLeft() == NULL) break;
@@ -207,23 +330,51 @@ void AVLTree<Key, Value>::insert (const std::pair<const Key, Value> &new_item)
 				// if(debug)
 				// std::cout << "right ";
 			}
+			++depth;
 		}
+		BST_STATS_DEPTH(depth + 1);
 
 		// if we made it out we are at a leaf
-		AVLNode<Key, Value>* n = new AVLNode<Key, Value>(new_item.first, new_item.second, temp);
-		if(temp->getKey()>new_item.first)
-			temp->setLeft(n);
-		else 
-			temp->setRight(n);
+		linkNode(temp, new_item.first, new_item.second);
+}
 
-		// std::cout << "New insert :D" << std::endl;
-		// if(debug)
-		// std::cout << std::endl << "End of insert, now calling setTreeBalance" << std::endl;
-		// if(debug) BinarySearchTree<Key,Value>::print();
-		
-		setTreeBalance(n);
-		
+/**
+* As for std::map, the key is first checked against hint and the neighbour on its side.
+* If it falls between them, one of the two has a free child slot there: hint itself
+* when its subtree on that side is empty, the neighbour otherwise, as the neighbour is
+* then the nearest node inside that subtree. Reaching the neighbour is O(1) amortized
+* over hints that advance in key order, and at worst the height of hint's subtree or
+* of its climb to the root.
+*
+* A key that does not belong next to hint is searched for from it, climbing only as
+* far as the first ancestor whose subtree must hold the key, so the cost grows with
+* the log of the distance in key order rather than of the tree size; end() starts from
+* the rightmost node.
+*/
+template<class Key, class Value>
+typename AVLTree<Key, Value>::iterator AVLTree<Key, Value>::insert(iterator hint, const std::pair<const Key, Value>& new_item)
+{
+    BST_STATS_OP(TREE_OP_INSERT);
+    if(this->trace_ != NULL) this->trace_->record(TRACE_INSERT, new_item.first);
+    if(this->root_ == NULL)
+        return this->iteratorAt(linkNode(NULL, new_item.first, new_item.second));
+
+    BST_STATS_VISIT();
+    BST_STATS_COMPARE(1);
+    if(rightmost_->getKey() < new_item.first)
+        return this->iteratorAt(linkNode(rightmost_, new_item.first, new_item.second));
 
+    Node<Key, Value>* finger = BinarySearchTree<Key, Value>::iteratorNode(hint);
+    AVLNode<Key, Value>* parent = NULL;
+    if(finger != NULL) parent = hintParent(static_cast<AVLNode<Key, Value>*>(finger), new_item.first);
+    if(parent == NULL) parent = descendFrom(finger != NULL ? static_cast<AVLNode<Key, Value>*>(finger) : rightmost_, new_item.first);
+    if(parent->getKey() == new_item.first)
+    {
+        parent->setValue(new_item.second);
+        pullUpPath(parent);
+        return this->iteratorAt(parent);
+    }
+    return this->iteratorAt(linkNode(parent, new_item.first, new_item.second));
 }
 
 /*
@@ -234,121 +385,449 @@ template<class Key, class Value>
 void AVLTree<Key, Value>:: remove(const Key& key)
 {
     // TODO
+		BST_STATS_OP(TREE_OP_REMOVE);
+		if(this->trace_!=NULL) this->trace_->record(TRACE_REMOVE, key);
 		AVLNode<Key, Value> * to_remove = internalFind(key);
-		
-			// std::cout << "remove time " << key << std::endl;
-			
-			
 		if(to_remove==NULL) return;
+		removeNode(to_remove);
+}
 
-		if((to_remove==BinarySearchTree<Key,Value>::root_) && ( BinarySearchTree<Key, Value>::height(BinarySearchTree<Key,Value>::root_) == 1))
+/**
+* Unlinks and deletes to_remove, then rebalances. Every other node stays where it is
+* in key order, so iterators to them remain valid.
+*/
+template<class Key, class Value>
+void AVLTree<Key, Value>::removeNode(AVLNode<Key, Value>* to_remove)
+{
+		// the predecessor has no right child, so after the swap to_remove has at most one child
+		if(to_remove->getLeft()!=NULL && to_remove->getRight()!=NULL)
 		{
-			// std::cout << "\tidentified root" << std::endl;
-			BinarySearchTree<Key,Value>::root_ = NULL;
-			AVLroot_ = NULL;
-			delete to_remove;
-			return;
+			Node<Key,Value>* asNode = to_remove;
+			nodeSwap(to_remove, static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::predecessor(asNode)));
 		}
 
-		AVLNode<Key, Value>* ogP = to_remove->getParent(); 
+		AVLNode<Key, Value>* child = to_remove->getLeft()!=NULL ? to_remove->getLeft() : to_remove->getRight();
+		AVLNode<Key, Value>* ogP = to_remove->getParent();
+		int8_t diff = 0;
 
-		if(to_remove->getLeft()==NULL && to_remove->getRight()==NULL)
+		if(child!=NULL) child->setParent(ogP);
+		if(ogP==NULL)
 		{
-			if(ogP->getRight() == to_remove)
-				ogP->setRight(NULL);
-			else
-				ogP->setLeft(NULL);
+			AVLroot_ = child;
+			BinarySearchTree<Key,Value>::root_ = AVLroot_;
 		}
-		else if(to_remove->getLeft()==NULL)
+		else if(ogP->getLeft()==to_remove)
 		{
-			Node<Key,Value>* removeNode = to_remove;
-			AVLNode<Key, Value>* swap = 
-				internalFind(BinarySearchTree<Key, Value>::successor(removeNode)->getKey());
-			nodeSwap(to_remove, swap);
-			ogP = to_remove->getParent(); 
-
-			if(ogP==swap)
-			{
-				if(to_remove->getRight()!= NULL)
-				{
-					ogP->setRight(to_remove->getRight());
-					to_remove->getRight()->setParent(ogP);
-				}
-				else
-				{
-					ogP->setRight(NULL);
-					if(to_remove->getLeft()!=NULL)
-					{	
-						ogP->setRight(to_remove->getLeft());
-						to_remove->getLeft()->setParent(ogP);
-					}
-				}
-			}
-			else
-			{
-				if(to_remove->getLeft()!= NULL)
-				{
-				  ogP->setLeft(to_remove->getLeft());
-					to_remove->getLeft()->setParent(ogP);
-				}
-				else
-				{
-					ogP->setLeft(NULL);
-					if(to_remove->getRight()!=NULL)
-					{	
-						ogP->setLeft(to_remove->getRight());
-						to_remove->getRight()->setParent(ogP);
-					}
-				}
-			}
+			ogP->setLeft(child);
+			diff = 1;
 		}
 		else
 		{
-			
-			Node<Key,Value>* removeNode = to_remove;
-			AVLNode<Key, Value>* swap = 
-				internalFind(BinarySearchTree<Key, Value>::predecessor(removeNode)->getKey());
-			nodeSwap(to_remove, swap);
-			ogP = to_remove->getParent(); 
-
-			if(ogP!=swap)
-			{
-				if(to_remove->getRight()!= NULL)
-				{	
-					ogP->setRight(to_remove->getRight());
-					to_remove->getRight()->setParent(ogP);
-				}
-				else
-				{
-					ogP->setRight(NULL);
-					if(to_remove->getLeft()!=NULL)
-					{	
-						ogP->setRight(to_remove->getLeft());
-						to_remove->getLeft()->setParent(ogP);
-					}
-				}
-			}
-			else
-			{
-				if(to_remove->getLeft()!= NULL)
-				{
-					ogP->setLeft(to_remove->getLeft());
-					to_remove->getLeft()->setParent(ogP);
-				}
-				else
-				{
-					ogP->setLeft(NULL);
-					if(to_remove->getRight()!=NULL)
-					{	
-						ogP->setLeft(to_remove->getRight());
-						to_remove->getRight()->setParent(ogP);
-					}
-				}
-			}
+			ogP->setRight(child);
+			diff = -1;
 		}
-		
+
+		++epoch_;
+		// the rightmost node has no right child, so it never takes part in the swap above
+		if(to_remove==rightmost_)
+		{
+			rightmost_ = child!=NULL ? child : ogP;
+			while(rightmost_!=NULL && rightmost_->getRight()!=NULL) rightmost_ = rightmost_->getRight();
+		}
+
+		this->forgetNode(to_remove);
 		delete to_remove;
-		setTreeBalance(ogP);
+		pullUpPath(ogP);
+		removeFix(ogP, diff);
+}
+
+/**
+* Sorted keys land next to each other, so after the first one each search only climbs
+* to the nearest ancestor above the new key and walks back down: O(k log(n/k)) for
+* k spread-out keys and O(k) amortized for adjacent ones, against O(k log n) for k
+* separate insert() calls. Rebalancing is still per key, but AVL insertion rotates
+* O(1) times amortized.
+*/
+template<class Key, class Value>
+template<typename InputIt>
+void AVLTree<Key, Value>::insertBatch(InputIt first, InputIt last)
+{
+    std::vector<std::pair<Key, Value> > batch(first, last);
+    if(!std::is_sorted(batch.begin(), batch.end(), BatchKeyLess()))
+        std::stable_sort(batch.begin(), batch.end(), BatchKeyLess());
+    insertSorted(batch);
+}
+
+template<class Key, class Value>
+void AVLTree<Key, Value>::insertSorted(const std::vector<std::pair<Key, Value> >& batch)
+{
+    AVLNode<Key, Value>* finger = NULL;
+    for(size_t i = 0; i < batch.size(); i++)
+    {
+        BST_STATS_OP(TREE_OP_INSERT);
+        if(this->trace_ != NULL) this->trace_->record(TRACE_INSERT, batch[i].first);
+        if(this->root_ == NULL)
+        {
+            finger = linkNode(NULL, batch[i].first, batch[i].second);
+            continue;
+        }
+
+        AVLNode<Key, Value>* parent = descendFrom(finger, batch[i].first);
+        if(parent->getKey() == batch[i].first)
+        {
+            parent->setValue(batch[i].second);
+            pullUpPath(parent);
+            finger = parent;
+            continue;
+        }
+
+        finger = linkNode(parent, batch[i].first, batch[i].second);
+    }
+}
+
+/**
+* The search for each key starts from the removed node's successor, or from the node
+* where the previous key was found missing.
+*/
+template<class Key, class Value>
+template<typename InputIt>
+void AVLTree<Key, Value>::eraseBatch(InputIt first, InputIt last)
+{
+    std::vector<Key> batch(first, last);
+    if(!std::is_sorted(batch.begin(), batch.end()))
+        std::sort(batch.begin(), batch.end());
+    eraseSorted(batch);
+}
+
+template<class Key, class Value>
+void AVLTree<Key, Value>::eraseSorted(const std::vector<Key>& batch)
+{
+    AVLNode<Key, Value>* finger = NULL;
+    for(size_t i = 0; i < batch.size(); i++)
+    {
+        BST_STATS_OP(TREE_OP_REMOVE);
+        if(this->trace_ != NULL) this->trace_->record(TRACE_REMOVE, batch[i]);
+        if(this->root_ == NULL) continue;
+
+        AVLNode<Key, Value>* n = descendFrom(finger, batch[i]);
+        if(!(n->getKey() == batch[i]))
+        {
+            finger = n;
+            continue;
+        }
+        finger = nextNode(n);
+        removeNode(n);
+    }
+}
+
+/**
+* Climbs while finger's subtree cannot hold key, which for a key above finger means
+* until the first ancestor reached from its left whose key is above key, and for a key
+* below finger the mirror image. A finger at key itself is returned before any climb.
+*/
+template<class Key, class Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::descendFrom(AVLNode<Key, Value>* finger, const Key& key) const
+{
+    AVLNode<Key, Value>* n = finger != NULL ? finger : AVLroot_;
+    if(n->getKey() == key)
+    {
+        BST_STATS_VISIT();
+        BST_STATS_COMPARE(1);
+        BST_STATS_DEPTH(1);
+        return n;
+    }
+    bool below = key < n->getKey();
+    while(n->getParent() != NULL)
+    {
+        AVLNode<Key, Value>* p = n->getParent();
+        if(below ? p->getRight() == n && p->getKey() < key : p->getLeft() == n && key < p->getKey()) break;
+        n = p;
+    }
+
+    int depth = 1;
+    while(true)
+    {
+        BST_STATS_VISIT();
+        BST_STATS_COMPARE(1);
+        if(n->getKey() == key) break;
+        AVLNode<Key, Value>* next = key < n->getKey() ? n->getLeft() : n->getRight();
+        if(next == NULL) break;
+        n = next;
+        ++depth;
+    }
+    BST_STATS_DEPTH(depth);
+    return n;
+}
+
+/**
+* The sort is stable, so of the pairs with one key the last one ends up last in its
+* run. The nodes of each subtree are allocated by the thread that builds it, so with a
+* malloc that keeps per-thread arenas (glibc's does) they come from that thread's arena
+* without contending for a shared heap. Each surviving pair is traced as one insert.
+*/
+template<class Key, class Value>
+template<typename InputIt>
+void AVLTree<Key, Value>::buildParallel(InputIt first, InputIt last, unsigned threads)
+{
+    std::vector<std::pair<Key, Value> > batch(first, last);
+    WorkStealingPool pool(threads);
+    if(!std::is_sorted(batch.begin(), batch.end(), BatchKeyLess()))
+        parallelStableSort(batch, BatchKeyLess(), pool);
+
+    size_t kept = 0;
+    for(size_t i = 0; i < batch.size(); i++)
+    {
+        if(i + 1 < batch.size() && batch[i].first == batch[i + 1].first) continue;
+        if(kept != i) batch[kept] = std::move(batch[i]);
+        kept++;
+    }
+    batch.erase(batch.begin() + kept, batch.end());
+
+    if(this->root_ != NULL)
+    {
+        insertSorted(batch);
+        return;
+    }
+    if(this->trace_ != NULL)
+    {
+        for(size_t i = 0; i < batch.size(); i++) this->trace_->record(TRACE_INSERT, batch[i].first);
+    }
+    buildSorted(batch, pool);
+}
+
+/**
+* The levels above the cut are built on this thread, leaving about 8 subtrees per
+* thread for the pool; their balances and hooks are set once the subtrees below them
+* are done. If making a node throws, the partial tree is cleared.
+*/
+template<class Key, class Value>
+void AVLTree<Key, Value>::buildSorted(const std::vector<std::pair<Key, Value> >& batch, WorkStealingPool& pool)
+{
+    if(batch.empty()) return;
+
+    int cutDepth = 0;
+    for(size_t w = 1; w < 8 * (size_t)pool.threads(); w *= 2) cutDepth++;
+
+    std::vector<BuildRange> tasks;
+    std::vector<BuildRange> topRanges;
+    std::vector<AVLNode<Key, Value>*> topNodes;
+    try
+    {
+        std::vector<std::pair<BuildRange, int> > stack;
+        BuildRange whole = { 0, batch.size(), NULL, 0 };
+        stack.push_back(std::make_pair(whole, 0));
+        while(!stack.empty())
+        {
+            BuildRange range = stack.back().first;
+            int depth = stack.back().second;
+            stack.pop_back();
+            if(range.lo >= range.hi) continue;
+            if(depth == cutDepth)
+            {
+                tasks.push_back(range);
+                continue;
+            }
+
+            AVLNode<Key, Value>* n = buildNode(batch, range);
+            topRanges.push_back(range);
+            topNodes.push_back(n);
+            size_t mid = range.lo + (range.hi - range.lo) / 2;
+            BuildRange right = { mid + 1, range.hi, n, 1 };
+            BuildRange left = { range.lo, mid, n, 0 };
+            stack.push_back(std::make_pair(right, depth + 1));
+            stack.push_back(std::make_pair(left, depth + 1));
+        }
+
+        BuildTask task = { this, &batch, &tasks };
+        pool.run(tasks.size(), task);
+    }
+    catch(...)
+    {
+        clear();
+        throw;
+    }
+
+    // parents were built before their children, so in reverse the children come first
+    for(size_t i = topNodes.size(); i-- > 0; )
+    {
+        size_t mid = topRanges[i].lo + (topRanges[i].hi - topRanges[i].lo) / 2;
+        setChildHeights(topNodes[i], builtHeight(mid - topRanges[i].lo), builtHeight(topRanges[i].hi - mid - 1));
+        pullUp(topNodes[i]);
+    }
+
+    rightmost_ = AVLroot_;
+    while(rightmost_ != NULL && rightmost_->getRight() != NULL) rightmost_ = rightmost_->getRight();
+    if(!this->bloom_.empty()) this->rebuildBloom();
+}
+
+template<class Key, class Value>
+void AVLTree<Key, Value>::buildSubtree(const std::vector<std::pair<Key, Value> >& batch, const BuildRange& range)
+{
+    if(range.lo >= range.hi) return;
+    AVLNode<Key, Value>* n = buildNode(batch, range);
+    size_t mid = range.lo + (range.hi - range.lo) / 2;
+    BuildRange left = { range.lo, mid, n, 0 };
+    BuildRange right = { mid + 1, range.hi, n, 1 };
+    buildSubtree(batch, left);
+    buildSubtree(batch, right);
+    setChildHeights(n, builtHeight(mid - range.lo), builtHeight(range.hi - mid - 1));
+    pullUp(n);
+}
+
+/**
+* Makes the node for the middle pair of range and hangs it in place straight away, so
+* that clear() can find every node of a build that fails part way.
+*/
+template<class Key, class Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::buildNode(const std::vector<std::pair<Key, Value> >& batch, const BuildRange& range)
+{
+    size_t mid = range.lo + (range.hi - range.lo) / 2;
+    AVLNode<Key, Value>* n = makeNode(batch[mid].first, batch[mid].second, range.parent);
+    if(range.parent == NULL)
+    {
+        AVLroot_ = n;
+        this->root_ = AVLroot_;
+    }
+    else if(range.side == 0) range.parent->setLeft(n);
+    else range.parent->setRight(n);
+    return n;
+}
+
+/**
+* Splitting at the middle keeps the two sides within one pair of each other, so the
+* height is the bit length of size, like a heap's.
+*/
+template<class Key, class Value>
+int AVLTree<Key, Value>::builtHeight(size_t size)
+{
+    int height = 0;
+    for(; size > 0; size >>= 1) height++;
+    return height;
+}
+
+template<class Key, class Value>
+void AVLTree<Key, Value>::setChildHeights(AVLNode<Key, Value>* n, int leftHeight, int rightHeight)
+{
+    n->setBalance((int8_t)(rightHeight - leftHeight));
+}
+
+template<class Key, class Value>
+void AVLTree<Key, Value>::clear()
+{
+    ++epoch_;
+    BinarySearchTree<Key, Value>::clear();
+    AVLroot_ = NULL;
+    rightmost_ = NULL;
+}
+
+template<class Key, class Value>
+typename AVLTree<Key, Value>::Cursor AVLTree<Key, Value>::cursor() const
+{
+    return Cursor(this);
+}
+
+template<class Key, class Value>
+AVLTree<Key, Value>::Cursor::Cursor() :
+    tree_(NULL), node_(NULL), epoch_(0)
+{
+}
+
+template<class Key, class Value>
+AVLTree<Key, Value>::Cursor::Cursor(const AVLTree<Key, Value>* tree) :
+    tree_(tree), node_(NULL), epoch_(tree->epoch_)
+{
+}
+
+/**
+* A finger search: climb from the cursor's node only until the subtree holds key, then
+* descend. For keys d apart in rank that is O(log d) steps, except when the two keys
+* sit either side of a high ancestor, where the climb goes up to it (O(log n) at
+* worst, no worse than find()). A removal anywhere in the tree since the last seek
+* may have deleted the node, so then the search starts from the root.
+*/
+template<class Key, class Value>
+typename AVLTree<Key, Value>::iterator AVLTree<Key, Value>::Cursor::seek(const Key& key)
+{
+    BST_STATS_OP(TREE_OP_FIND);
+    if(tree_->trace_ != NULL) tree_->trace_->record(TRACE_FIND, key);
+    if(epoch_ != tree_->epoch_)
+    {
+        node_ = NULL;
+        epoch_ = tree_->epoch_;
+    }
+    if(tree_->root_ == NULL) return tree_->end();
+
+    node_ = tree_->descendFrom(node_, key);
+    if(node_->getKey() == key) return tree_->iteratorAt(node_);
+    return tree_->end();
+}
+
+template<class Key, class Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::linkNode(AVLNode<Key, Value>* parent, const Key& key, const Value& value)
+{
+    AVLNode<Key, Value>* n = makeNode(key, value, parent);
+    this->rememberKey(key);
+    if(parent == NULL)
+    {
+        AVLroot_ = n;
+        this->root_ = AVLroot_;
+        rightmost_ = n;
+        return n;
+    }
+
+    if(key < parent->getKey()) parent->setLeft(n);
+    else parent->setRight(n);
+    if(parent == rightmost_ && parent->getRight() == n) rightmost_ = n;
+    pullUpPath(n);
+    insertFix(n);
+    return n;
+}
+
+template<class Key, class Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::hintParent(AVLNode<Key, Value>* n, const Key& key) const
+{
+    BST_STATS_VISIT();
+    BST_STATS_COMPARE(1);
+    if(n->getKey() == key) return n;
+    bool below = key < n->getKey();
+    AVLNode<Key, Value>* neighbour = below ? prevNode(n) : nextNode(n);
+    if(neighbour != NULL)
+    {
+        BST_STATS_VISIT();
+        BST_STATS_COMPARE(1);
+        if(neighbour->getKey() == key) return neighbour;
+        if(below ? !(neighbour->getKey() < key) : !(key < neighbour->getKey())) return NULL;
+    }
+    if(below) return n->getLeft() == NULL ? n : neighbour;
+    return n->getRight() == NULL ? n : neighbour;
+}
+
+template<class Key, class Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::nextNode(Node<Key, Value>* n)
+{
+    if(n->getRight() != NULL)
+        return static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::successor(n));
+    Node<Key, Value>* parent = n->getParent();
+    while(parent != NULL && parent->getRight() == n)
+    {
+        n = parent;
+        parent = parent->getParent();
+    }
+    return static_cast<AVLNode<Key, Value>*>(parent);
+}
+
+template<class Key, class Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::prevNode(Node<Key, Value>* n)
+{
+    if(n->getLeft() != NULL)
+        return static_cast<AVLNode<Key, Value>*>(BinarySearchTree<Key, Value>::predecessor(n));
+    Node<Key, Value>* parent = n->getParent();
+    while(parent != NULL && parent->getLeft() == n)
+    {
+        n = parent;
+        parent = parent->getParent();
+    }
+    return static_cast<AVLNode<Key, Value>*>(parent);
 }
 
 template<class Key, class Value>
@@ -367,69 +846,114 @@ void AVLTree<Key, Value>::nodeSwap( AVLNode<Key,Value>* n1, AVLNode<Key,Value>*
     }
 }
 
+/**
+* Walks up from a newly inserted leaf n, updating balances until the subtree
+* stops growing. At most one (single or double) rotation is needed.
+*/
 template<class Key, class Value>
-void AVLTree<Key, Value>:: setTreeBalance(AVLNode<Key, Value>* n)
+void AVLTree<Key, Value>::insertFix(AVLNode<Key, Value>* n)
 {
-	AVLNode<Key, Value>* temp = n;
-	while(temp!=NULL)
+	AVLNode<Key, Value>* p = n->getParent();
+	while(p!=NULL)
 	{
-		
-		int b = BinarySearchTree<Key, Value>::height(temp->getRight())-BinarySearchTree<Key, Value>::height(temp->getLeft());
-		// std::cout << "we at node " << temp->getKey() << " setting balance of " << b << std::endl;
-		temp->setBalance(b);
-		temp = temp->getParent();
+		p->updateBalance(p->getLeft()==n ? -1 : 1);
+		if(p->getBalance()==0) return;
+		if(p->getBalance()>1 || p->getBalance()<-1)
+		{
+			fixBalance(p);
+			return;
+		}
+		n = p;
+		p = p->getParent();
 	}
-
-	checkBalance(n);
 }
 
+/**
+* Walks up from n after one of its subtrees got shorter; diff is +1 if it was
+* the left subtree and -1 if it was the right one. Stops once a subtree keeps
+* its height.
+*/
 template<class Key, class Value>
-void AVLTree<Key, Value>:: checkBalance(AVLNode<Key, Value>* n)
+void AVLTree<Key, Value>::removeFix(AVLNode<Key, Value>* n, int8_t diff)
 {
-	// std::cout << "we at leaf " << n->getKey() << std::endl;
-	AVLNode<Key, Value>* temp = n;
-	while(temp!=NULL)
+	while(n!=NULL)
 	{
-		if(abs(temp->getBalance())>1){
-						// std::cout << "I guess we fix on " << temp->getKey() << std::endl;
-						fixBalance(temp);
-						break;}
-		temp = temp->getParent();
+		AVLNode<Key, Value>* p = n->getParent();
+		int8_t pdiff = (p!=NULL && p->getLeft()==n) ? 1 : -1;
+
+		n->updateBalance(diff);
+		if(n->getBalance()==1 || n->getBalance()==-1) return;
+		if(n->getBalance()!=0)
+		{
+			n = fixBalance(n);
+			// a rotation that leaves the new root unbalanced did not change the height
+			if(n->getBalance()!=0) return;
+		}
+		n = p;
+		diff = pdiff;
 	}
 }
 
+/**
+* Hands the stored balance factors to exportDot()/exportJsonLines().
+*/
+template<class Key, class Value>
+bool AVLTree<Key, Value>::nodeBalance(const Node<Key, Value>* n, int& balance) const
+{
+    balance = static_cast<const AVLNode<Key, Value>*>(n)->getBalance();
+    return true;
+}
+
+template<class Key, class Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::makeNode(const Key& key, const Value& value, AVLNode<Key, Value>* parent)
+{
+    return new AVLNode<Key, Value>(key, value, parent);
+}
+
 template<class Key, class Value>
-void AVLTree<Key, Value>::fixBalance(AVLNode<Key, Value>* n)
+void AVLTree<Key, Value>::pullUp(AVLNode<Key, Value>*)
+{
+}
+
+template<class Key, class Value>
+void AVLTree<Key, Value>::pullUpPath(AVLNode<Key, Value>*)
+{
+}
+
+/**
+* Rotates around n, whose balance is +2 or -2, and returns the new root of
+* that subtree.
+*/
+template<class Key, class Value>
+AVLNode<Key, Value>* AVLTree<Key, Value>::fixBalance(AVLNode<Key, Value>* n)
 {
-	// std::cout << "start of fixBalance" << std::endl;
-		// BinarySearchTree<Key,Value>::print();
 		if(n->getBalance()>1)
 		{
-			// std::cout << "decided on right zig ";
 			if(n->getRight()->getBalance()<0)
 			{
-				// std:: cout << "zag";
-				// Node* ogR = n->getRight();
+				BST_STATS_COUNT(doubleRotations);
 				rotateRight(n->getRight());
-				rotateLeft(n);
 			}
 			else
-				rotateLeft(n);
+			{
+				BST_STATS_COUNT(singleRotations);
+			}
+			rotateLeft(n);
 		}
-		if(n->getBalance()<-1)
+		else
 		{
-			// std::cout << "decided on left zig ";
 			if(n->getLeft()->getBalance()>0)
-			{		
-				// std:: cout << "zag";		
+			{
+				BST_STATS_COUNT(doubleRotations);
 				rotateLeft(n->getLeft());
-				rotateRight(n);
 			}
 			else
-				rotateRight(n);
+			{
+				BST_STATS_COUNT(singleRotations);
+			}
+			rotateRight(n);
 		}
-	// std::cout << std::endl;
-	setTreeBalance(n);
+		return n->getParent();
 }
 
 template<class Key, class Value>
@@ -438,41 +962,34 @@ void AVLTree<Key, Value>::rotateRight(AVLNode<Key, Value>* n)
 	AVLNode<Key, Value>* ogP = n->getParent();
 	AVLNode<Key, Value>* ogL = n->getLeft();
 	
+	n->setLeft(ogL->getRight());
 	if(ogL->getRight()!=NULL)
-	{	
-		n->setLeft(ogL->getRight());
 		ogL->getRight()->setParent(n);
-	}
-	else
-		n->setLeft(NULL);
 	
 	n->setParent(ogL);
+	ogL->setParent(ogP);
 	
 	if(ogP!=NULL)
 	{
-		ogL->setParent(ogP);
-		if(ogP->getRight()==n){
+		if(ogP->getRight()==n)
 			ogP->setRight(ogL);
-			ogP->setBalance(ogL->getBalance());
-		}
 		else
 			ogP->setLeft(ogL);
 	}
 	else
 	{
-		ogL->setParent(NULL);
 		AVLroot_ = ogL;
 		BinarySearchTree<Key,Value>::root_ = AVLroot_;
 	}
 	
 	ogL->setRight(n);
-	
-	if(n!=NULL)
-		n->setBalance(BinarySearchTree<Key, Value>::height(n->getRight())-BinarySearchTree<Key, Value>::height(n->getLeft()));
-	if(ogL!=NULL)
-		ogL->setBalance(BinarySearchTree<Key, Value>::height(ogL->getRight())-BinarySearchTree<Key, Value>::height(ogL->getLeft()));
-	if(ogP!=NULL)
-		ogP->setBalance(BinarySearchTree<Key, Value>::height(ogP->getRight())-BinarySearchTree<Key, Value>::height(ogP->getLeft()));
+
+	// only n and ogL change height, and both follow from the old balances
+	int nb = n->getBalance() + 1 - std::min<int>(ogL->getBalance(), 0);
+	n->setBalance(nb);
+	ogL->setBalance(ogL->getBalance() + 1 + std::max(nb, 0));
+	pullUp(n);
+	pullUp(ogL);
 }
 
 template<class Key, class Value>
@@ -481,19 +998,15 @@ void AVLTree<Key, Value>::rotateLeft(AVLNode<Key, Value>* n)
 	AVLNode<Key, Value>* ogP = n->getParent();
 	AVLNode<Key, Value>* ogR = n->getRight();
 
+	n->setRight(ogR->getLeft());
 	if(ogR->getLeft()!=NULL)
-	{	
-		n->setRight(ogR->getLeft());
 		ogR->getLeft()->setParent(n);
-	}
-	else
-		n->setRight(NULL);
 	
 	n->setParent(ogR);
+	ogR->setParent(ogP);
 	
 	if(ogP!=NULL)
 	{
-		ogR->setParent(ogP);
 		if(ogP->getLeft()==n)
 			ogP->setLeft(ogR);
 		else
@@ -501,19 +1014,17 @@ void AVLTree<Key, Value>::rotateLeft(AVLNode<Key, Value>* n)
 	}
 	else
 	{
-		ogR->setParent(NULL);
 		AVLroot_ = ogR;
 		BinarySearchTree<Key,Value>::root_ = AVLroot_;
 	}
 
 	ogR->setLeft(n);
-	
-	if(n!=NULL)
-		n->setBalance(BinarySearchTree<Key, Value>::height(n->getRight())-BinarySearchTree<Key, Value>::height(n->getLeft()));
-	if(ogR!=NULL)
-		ogR->setBalance(BinarySearchTree<Key, Value>::height(ogR->getRight())-BinarySearchTree<Key, Value>::height(ogR->getLeft()));
-	if(ogP!=NULL)
-		ogP->setBalance(BinarySearchTree<Key, Value>::height(ogP->getRight())-BinarySearchTree<Key, Value>::height(ogP->getLeft()));
+
+	int nb = n->getBalance() - 1 - std::max<int>(ogR->getBalance(), 0);
+	n->setBalance(nb);
+	ogR->setBalance(ogR->getBalance() - 1 + std::min(nb, 0));
+	pullUp(n);
+	pullUp(ogR);
 }
 
 template<typename Key, typename Value>
@@ -522,10 +1033,15 @@ AVLNode<Key, Value>* AVLTree<Key, Value>::internalFind(const Key& key) const
     // TODO
 		if(BinarySearchTree<Key,Value>::root_==NULL) return NULL;
 		AVLNode<Key, Value>* temp = AVLroot_;
+		int depth = 1;
 		
 		while(temp->getLeft()!=NULL || temp->getRight()!=NULL)
 		{
+			BST_STATS_VISIT();
+			BST_STATS_DEPTH(depth);
+			BST_STATS_COMPARE(1);
 			if(temp->getKey() == key) return temp;
+			BST_STATS_COMPARE(1);
 			if(temp->getKey() > key)
 			{
 				if(temp->getLeft()==NULL) return NULL;
@@ -536,8 +1052,12 @@ AVLNode<Key, Value>* AVLTree<Key, Value>::internalFind(const Key& key) const
 				if(temp->getRight()==NULL) return NULL;
 				temp = temp->getRight();
 			}
+			++depth;
 		}
 
+		BST_STATS_VISIT();
+		BST_STATS_DEPTH(depth);
+		BST_STATS_COMPARE(1);
 		if(temp->getKey() == key) return temp;
 		return NULL;
 
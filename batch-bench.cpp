@@ -0,0 +1,105 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
+#include "bench_utils.h"
+#include "avlbst.h"
+
+using namespace std;
+
+// AVLTree::insertBatch()/eraseBatch() against one insert()/remove() call per key.
+//
+// usage: batch-bench [entries]
+//
+// The tree holds the even keys below 2 * entries. Each batch inserts odd keys and is
+// then erased again, so every batch sees the same tree. Spread batches draw their keys
+// from the whole range; clustered ones take consecutive odd keys from a random
+// window, as time-ordered ingest does. Each batch arrives sorted.
+
+static const size_t BATCH_SIZES[] = { 100, 1000, 10000, 100000 };
+static const size_t KEYS_PER_SIZE = 400000;
+
+typedef pair<int, int> Entry;
+
+static vector<Entry> makeBatch(size_t size, size_t n, bool clustered, mt19937& rng)
+{
+	vector<Entry> batch(size);
+	size_t base = clustered ? rng() % (n - size) : 0;
+	for(size_t i = 0; i < size; i++)
+	{
+		size_t slot = clustered ? base + i : rng() % n;
+		batch[i] = Entry((int)(2 * slot + 1), (int)i);
+	}
+	sort(batch.begin(), batch.end());
+	batch.erase(unique(batch.begin(), batch.end(), [](const Entry& a, const Entry& b) { return a.first == b.first; }), batch.end());
+	return batch;
+}
+
+static void run(AVLTree<int, int>& tree, size_t n, size_t size, bool clustered)
+{
+	mt19937 rng(42);
+	size_t rounds = max<size_t>(1, KEYS_PER_SIZE / size);
+	double loopInsert = 0, loopErase = 0, batchInsert = 0, batchErase = 0;
+	size_t keys = 0;
+	for(size_t r = 0; r < rounds; r++)
+	{
+		vector<Entry> batch = makeBatch(size, n, clustered, rng);
+		vector<int> batchKeys(batch.size());
+		for(size_t i = 0; i < batch.size(); i++) batchKeys[i] = batch[i].first;
+		keys += batch.size();
+
+		// alternate which goes first, so neither always finds the other's paths cached
+		for(int pass = 0; pass < 2; pass++)
+		{
+			Stopwatch watch;
+			if((pass + r) % 2 == 0)
+			{
+				for(size_t i = 0; i < batch.size(); i++) tree.insert(batch[i]);
+				loopInsert += watch.seconds();
+				watch.restart();
+				for(size_t i = 0; i < batchKeys.size(); i++) tree.remove(batchKeys[i]);
+				loopErase += watch.seconds();
+			}
+			else
+			{
+				tree.insertBatch(batch.begin(), batch.end());
+				batchInsert += watch.seconds();
+				watch.restart();
+				tree.eraseBatch(batchKeys.begin(), batchKeys.end());
+				batchErase += watch.seconds();
+			}
+		}
+	}
+
+	cout << "  " << (clustered ? "clustered" : "spread   ") << " batch " << size << endl;
+	cout << "    insert loop keys/s:  " << (uint64_t)(keys / loopInsert) << endl;
+	cout << "    insertBatch keys/s:  " << (uint64_t)(keys / batchInsert) << " (" << loopInsert / batchInsert << "x)" << endl;
+	cout << "    remove loop keys/s:  " << (uint64_t)(keys / loopErase) << endl;
+	cout << "    eraseBatch keys/s:   " << (uint64_t)(keys / batchErase) << " (" << loopErase / batchErase << "x)" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+	if(n <= BATCH_SIZES[sizeof(BATCH_SIZES) / sizeof(BATCH_SIZES[0]) - 1])
+	{
+		cerr << "usage: " << argv[0] << " [entries > largest batch]" << endl;
+		return 1;
+	}
+
+	mt19937 rng(42);
+	vector<int> keys(n);
+	for(size_t i = 0; i < n; i++) keys[i] = (int)(2 * i);
+	shuffle(keys.begin(), keys.end(), rng);
+	AVLTree<int, int> tree;
+	for(size_t i = 0; i < n; i++) tree.insert(make_pair(keys[i], (int)i));
+
+	cout << "AVLTree<int,int> with " << n << " entries" << endl;
+	for(size_t s = 0; s < sizeof(BATCH_SIZES) / sizeof(BATCH_SIZES[0]); s++)
+	{
+		run(tree, n, BATCH_SIZES[s], false);
+		run(tree, n, BATCH_SIZES[s], true);
+	}
+	return 0;
+}
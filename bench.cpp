@@ -0,0 +1,327 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <thread>
+#include <random>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include "bench_utils.h"
+#include "bst.h"
+#include "avlbst.h"
+#include "splay_tree.h"
+#include "rbbst.h"
+#include "wavlbst.h"
+
+using namespace std;
+
+// Mixed-workload benchmark driver.
+//
+// usage: bench [--tree=bst|avl|wavl|rb|splay|map] [--dist=uniform|sequential|zipfian] [--zipf=0.99]
+//              [--mix=READ:INSERT:REMOVE:SCAN] [--size=N] [--ops=N] [--threads=T]
+//              [--scan-length=L] [--seed=S] [--trace=FILE]
+//
+// The tree is preloaded with --size keys, then each thread runs --ops operations drawn
+// from the --mix percentages. The trees are not thread-safe, so with --threads > 1 every
+// thread owns a shard: its own tree holding size/threads keys. Results are printed as
+// one JSON object: throughput, per-operation latency percentiles and peak RSS.
+// --trace records every operation on thread 0's tree, preload included, for trace-replay.
+
+struct Config
+{
+	Config() : tree("avl"), dist("uniform"), zipf(0.99), size(100000), ops(1000000),
+		threads(1), scanLength(100), seed(104)
+	{
+		mix[0] = 90; mix[1] = 5; mix[2] = 5; mix[3] = 0;
+	}
+
+	string tree;
+	string dist;
+	double zipf;
+	int mix[4];
+	uint64_t size;
+	uint64_t ops;
+	int threads;
+	int scanLength;
+	uint64_t seed;
+	string trace;
+};
+
+enum OpKind { OP_READ = 0, OP_INSERT, OP_REMOVE, OP_SCAN, NUM_OPS };
+static const char* OP_NAMES[NUM_OPS] = { "read", "insert", "remove", "scan" };
+
+// Generates the keys one thread's operations touch.
+class KeyChooser
+{
+public:
+	KeyChooser(const Config& cfg, uint64_t keySpace, uint64_t preloaded, uint64_t seed) :
+		dist_(cfg.dist), keySpace_(keySpace), next_(preloaded), rng_(seed), uniform_(0, keySpace - 1),
+		zipf_(cfg.dist == "zipfian" ? new ZipfGenerator(keySpace, cfg.zipf) : NULL)
+	{
+
+	}
+
+	~KeyChooser()
+	{
+		delete zipf_;
+	}
+
+	// key for a read/remove/scan
+	uint64_t existing()
+	{
+		if(dist_ == "sequential") return next_ == 0 ? 0 : uniformBelow(next_);
+		return pick();
+	}
+
+	// key for an insert
+	uint64_t fresh()
+	{
+		if(dist_ == "sequential") return next_++;
+		return pick();
+	}
+
+	mt19937_64& rng() { return rng_; }
+
+private:
+	uint64_t pick()
+	{
+		if(zipf_ != NULL)
+		{
+			// scatter the popular ranks over the key space instead of clustering them
+			return ((*zipf_)(rng_) * 0x9E3779B97F4A7C15ull) % keySpace_;
+		}
+		return uniform_(rng_);
+	}
+
+	uint64_t uniformBelow(uint64_t n)
+	{
+		return uniform_int_distribution<uint64_t>(0, n - 1)(rng_);
+	}
+
+	string dist_;
+	uint64_t keySpace_;
+	uint64_t next_;
+	mt19937_64 rng_;
+	uniform_int_distribution<uint64_t> uniform_;
+	ZipfGenerator* zipf_;
+};
+
+template<typename Key, typename Value>
+static bool attachTrace(BinarySearchTree<Key, Value>& tree, TraceWriter<Key>* trace)
+{
+	tree.setTrace(trace);
+	return true;
+}
+
+template<typename Key, typename Value>
+static bool attachTrace(StdMapAdapter<Key, Value>&, TraceWriter<Key>*)
+{
+	return false;
+}
+
+struct ThreadResult
+{
+	ThreadResult() : hits(0), scanned(0) { }
+
+	LatencyHistogram latency[NUM_OPS];
+	uint64_t hits;
+	uint64_t scanned;
+};
+
+template<typename Tree>
+static void runThread(const Config& cfg, int id, double* loadSecs, ThreadResult* result)
+{
+	uint64_t shardSize = cfg.size / cfg.threads;
+	// reads should hit about half the time under uniform keys
+	uint64_t keySpace = shardSize * 2 > 0 ? shardSize * 2 : 1;
+	KeyChooser keys(cfg, keySpace, shardSize, cfg.seed + id);
+	// declared before the tree so it outlives it
+	unique_ptr<TraceWriter<uint64_t> > trace;
+	Tree tree;
+	if(id == 0 && !cfg.trace.empty())
+	{
+		trace.reset(new TraceWriter<uint64_t>(cfg.trace));
+		attachTrace(tree, trace.get());
+	}
+
+	Stopwatch load;
+	if(cfg.dist == "sequential")
+	{
+		for(uint64_t i = 0; i < shardSize; i++) tree.insert(make_pair(i, i));
+	}
+	else
+	{
+		vector<uint64_t> preload(keySpace);
+		for(uint64_t i = 0; i < keySpace; i++) preload[i] = i;
+		shuffle(preload.begin(), preload.end(), keys.rng());
+		for(uint64_t i = 0; i < shardSize; i++) tree.insert(make_pair(preload[i], i));
+	}
+	*loadSecs = load.seconds();
+
+	uniform_int_distribution<int> percent(0, 99);
+	for(uint64_t i = 0; i < cfg.ops; i++)
+	{
+		int roll = percent(keys.rng());
+		int kind = 0;
+		while(kind < NUM_OPS - 1 && roll >= cfg.mix[kind])
+		{
+			roll -= cfg.mix[kind];
+			kind++;
+		}
+
+		uint64_t key = kind == OP_INSERT ? keys.fresh() : keys.existing();
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		switch(kind)
+		{
+		case OP_READ:
+			if(tree.find(key) != tree.end()) result->hits++;
+			break;
+		case OP_INSERT:
+			tree.insert(make_pair(key, i));
+			break;
+		case OP_REMOVE:
+			tree.remove(key);
+			break;
+		case OP_SCAN:
+		{
+			typename Tree::iterator it = tree.find(key);
+			for(int n = 0; n < cfg.scanLength && it != tree.end(); n++, ++it)
+				result->scanned++;
+			break;
+		}
+		}
+		uint64_t ns = (uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+		result->latency[kind].record(ns);
+	}
+}
+
+template<typename Tree>
+static void run(const Config& cfg)
+{
+	vector<ThreadResult> results(cfg.threads);
+	vector<double> loadSecs(cfg.threads, 0.0);
+	vector<thread> workers;
+
+	Stopwatch wall;
+	for(int t = 0; t < cfg.threads; t++)
+		workers.push_back(thread(runThread<Tree>, cref(cfg), t, &loadSecs[t], &results[t]));
+	for(int t = 0; t < cfg.threads; t++)
+		workers[t].join();
+	double wallSecs = wall.seconds();
+
+	ThreadResult total;
+	double maxLoad = 0;
+	for(int t = 0; t < cfg.threads; t++)
+	{
+		for(int k = 0; k < NUM_OPS; k++) total.latency[k].merge(results[t].latency[k]);
+		total.hits += results[t].hits;
+		total.scanned += results[t].scanned;
+		if(loadSecs[t] > maxLoad) maxLoad = loadSecs[t];
+	}
+	uint64_t totalOps = cfg.ops * cfg.threads;
+	double runSecs = wallSecs - maxLoad;
+
+	ostringstream json;
+	json << "{\"tree\":\"" << cfg.tree << "\",\"dist\":\"" << cfg.dist << "\"";
+	if(cfg.dist == "zipfian") json << ",\"zipf\":" << cfg.zipf;
+	json << ",\"mix\":{";
+	for(int k = 0; k < NUM_OPS; k++) json << (k ? "," : "") << "\"" << OP_NAMES[k] << "\":" << cfg.mix[k];
+	json << "},\"size\":" << cfg.size << ",\"threads\":" << cfg.threads << ",\"ops\":" << totalOps
+		<< ",\"load_seconds\":" << maxLoad << ",\"run_seconds\":" << runSecs
+		<< ",\"throughput_ops_per_sec\":" << (runSecs > 0 ? totalOps / runSecs : 0)
+		<< ",\"read_hits\":" << total.hits << ",\"scanned_entries\":" << total.scanned
+		<< ",\"latency_ns\":{";
+	bool first = true;
+	for(int k = 0; k < NUM_OPS; k++)
+	{
+		const LatencyHistogram& h = total.latency[k];
+		if(h.count() == 0) continue;
+		json << (first ? "" : ",") << "\"" << OP_NAMES[k] << "\":{\"count\":" << h.count()
+			<< ",\"p50\":" << h.percentile(0.50) << ",\"p99\":" << h.percentile(0.99)
+			<< ",\"p999\":" << h.percentile(0.999) << ",\"max\":" << h.max() << "}";
+		first = false;
+	}
+	json << "},\"peak_rss_bytes\":" << peakResidentBytes() << "}";
+	cout << json.str() << endl;
+}
+
+static bool parseMix(const string& spec, int* mix)
+{
+	istringstream in(spec);
+	string part;
+	int k = 0, sum = 0;
+	while(getline(in, part, ':') && k < NUM_OPS)
+	{
+		mix[k] = atoi(part.c_str());
+		sum += mix[k++];
+	}
+	for(; k < NUM_OPS; k++) mix[k] = 0;
+	return sum == 100;
+}
+
+int main(int argc, char *argv[])
+{
+	Config cfg;
+	for(int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		size_t eq = arg.find('=');
+		string name = arg.substr(0, eq);
+		string value = eq == string::npos ? "" : arg.substr(eq + 1);
+
+		if(name == "--tree") cfg.tree = value;
+		else if(name == "--dist") cfg.dist = value;
+		else if(name == "--zipf") cfg.zipf = atof(value.c_str());
+		else if(name == "--size") cfg.size = strtoull(value.c_str(), NULL, 10);
+		else if(name == "--ops") cfg.ops = strtoull(value.c_str(), NULL, 10);
+		else if(name == "--threads") cfg.threads = atoi(value.c_str());
+		else if(name == "--scan-length") cfg.scanLength = atoi(value.c_str());
+		else if(name == "--seed") cfg.seed = strtoull(value.c_str(), NULL, 10);
+		else if(name == "--trace") cfg.trace = value;
+		else if(name == "--mix")
+		{
+			if(!parseMix(value, cfg.mix))
+			{
+				cerr << "--mix percentages must add up to 100" << endl;
+				return 1;
+			}
+		}
+		else
+		{
+			cerr << "unknown option " << arg << endl;
+			return 1;
+		}
+	}
+	if(cfg.threads < 1 || (cfg.dist != "uniform" && cfg.dist != "sequential" && cfg.dist != "zipfian"))
+	{
+		cerr << "bad --threads or --dist" << endl;
+		return 1;
+	}
+	if(cfg.dist == "zipfian" && (cfg.zipf <= 0 || cfg.zipf == 1.0))
+	{
+		cerr << "--zipf must be positive and not 1" << endl;
+		return 1;
+	}
+
+	if(!cfg.trace.empty() && cfg.tree == "map")
+	{
+		cerr << "--trace needs --tree=bst, avl, wavl, rb or splay" << endl;
+		return 1;
+	}
+
+	if(cfg.tree == "bst") run<BinarySearchTree<uint64_t, uint64_t> >(cfg);
+	else if(cfg.tree == "avl") run<AVLTree<uint64_t, uint64_t> >(cfg);
+	else if(cfg.tree == "wavl") run<WAVLTree<uint64_t, uint64_t> >(cfg);
+	else if(cfg.tree == "rb") run<RedBlackTree<uint64_t, uint64_t> >(cfg);
+	else if(cfg.tree == "splay") run<SplayTree<uint64_t, uint64_t> >(cfg);
+	else if(cfg.tree == "map") run<StdMapAdapter<uint64_t, uint64_t> >(cfg);
+	else
+	{
+		cerr << "unknown --tree " << cfg.tree << endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,174 @@
+#ifndef BENCH_UTILS_H
+#define BENCH_UTILS_H
+
+#include <fstream>
+#include <map>
+#include <utility>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <unistd.h>
+#include <sys/resource.h>
+
+// Small helpers shared by the *-bench drivers.
+
+// Resident set size of this process in bytes.
+inline size_t residentBytes()
+{
+	std::ifstream statm("/proc/self/statm");
+	size_t pages = 0, resident = 0;
+	statm >> pages >> resident;
+	return resident * (size_t)sysconf(_SC_PAGESIZE);
+}
+
+// Peak resident set size of this process in bytes.
+inline size_t peakResidentBytes()
+{
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return (size_t)usage.ru_maxrss * 1024;
+}
+
+// Wall-clock stopwatch, started on construction.
+class Stopwatch
+{
+public:
+	Stopwatch() : start_(std::chrono::steady_clock::now()) { }
+
+	void restart() { start_ = std::chrono::steady_clock::now(); }
+
+	double seconds() const
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+	}
+
+private:
+	std::chrono::steady_clock::time_point start_;
+};
+
+// Latency histogram in nanoseconds. Each power of two is split into 16 linear
+// sub-buckets, so a reported percentile is within about 6% of the true value.
+class LatencyHistogram
+{
+public:
+	LatencyHistogram() : counts_(64 * SUB_BUCKETS, 0), total_(0), max_(0) { }
+
+	void record(uint64_t ns)
+	{
+		++counts_[bucketOf(ns)];
+		++total_;
+		if(ns > max_) max_ = ns;
+	}
+
+	void merge(const LatencyHistogram& other)
+	{
+		for(size_t i = 0; i < counts_.size(); i++) counts_[i] += other.counts_[i];
+		total_ += other.total_;
+		if(other.max_ > max_) max_ = other.max_;
+	}
+
+	uint64_t count() const { return total_; }
+	uint64_t max() const { return max_; }
+
+	// Upper bound of the bucket holding the q-th quantile (0 < q <= 1).
+	uint64_t percentile(double q) const
+	{
+		if(total_ == 0) return 0;
+		uint64_t rank = (uint64_t)std::ceil(q * total_);
+		uint64_t seen = 0;
+		for(size_t i = 0; i < counts_.size(); i++)
+		{
+			seen += counts_[i];
+			if(seen >= rank) return upperBound(i) < max_ ? upperBound(i) : max_;
+		}
+		return max_;
+	}
+
+private:
+	static const int SUB_BUCKETS = 16;
+
+	static size_t bucketOf(uint64_t ns)
+	{
+		if(ns < SUB_BUCKETS) return (size_t)ns;
+		int exp = 63 - __builtin_clzll(ns);
+		uint64_t sub = (ns >> (exp - 4)) & (SUB_BUCKETS - 1);
+		return (size_t)(exp - 3) * SUB_BUCKETS + (size_t)sub;
+	}
+
+	static uint64_t upperBound(size_t bucket)
+	{
+		if(bucket < (size_t)SUB_BUCKETS) return bucket;
+		int exp = (int)(bucket / SUB_BUCKETS) + 3;
+		uint64_t sub = bucket % SUB_BUCKETS;
+		return ((SUB_BUCKETS + sub + 1) << (exp - 4)) - 1;
+	}
+
+	std::vector<uint64_t> counts_;
+	uint64_t total_;
+	uint64_t max_;
+};
+
+// Zipfian ranks in [0, n), rank 0 the most popular, using the method of
+// Gray et al. ("Quickly generating billion-record synthetic databases") as in YCSB.
+// Setup is O(n); each draw is O(1).
+class ZipfGenerator
+{
+public:
+	ZipfGenerator(uint64_t n, double theta) :
+		n_(n), theta_(theta), uniform_(0.0, 1.0)
+	{
+		zetan_ = zeta(n, theta);
+		double zeta2 = zeta(2, theta);
+		alpha_ = 1.0 / (1.0 - theta);
+		eta_ = (1.0 - std::pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetan_);
+	}
+
+	template<typename Rng>
+	uint64_t operator()(Rng& rng)
+	{
+		double u = uniform_(rng);
+		double uz = u * zetan_;
+		if(uz < 1.0) return 0;
+		if(uz < 1.0 + std::pow(0.5, theta_)) return 1;
+		uint64_t r = (uint64_t)(n_ * std::pow(eta_ * u - eta_ + 1.0, alpha_));
+		return r < n_ ? r : n_ - 1;
+	}
+
+private:
+	static double zeta(uint64_t n, double theta)
+	{
+		double sum = 0;
+		for(uint64_t i = 1; i <= n; i++) sum += 1.0 / std::pow((double)i, theta);
+		return sum;
+	}
+
+	uint64_t n_;
+	double theta_;
+	double zetan_;
+	double alpha_;
+	double eta_;
+	std::uniform_real_distribution<double> uniform_;
+};
+
+// std::map behind the same interface as the trees
+template<typename Key, typename Value>
+class StdMapAdapter
+{
+public:
+	typedef typename std::map<Key, Value>::iterator iterator;
+
+	void insert(const std::pair<const Key, Value>& kv) { map_[kv.first] = kv.second; }
+	void remove(const Key& key) { map_.erase(key); }
+	iterator find(const Key& key) { return map_.find(key); }
+	iterator begin() { return map_.begin(); }
+	iterator end() { return map_.end(); }
+	size_t size() const { return map_.size(); }
+
+private:
+	std::map<Key, Value> map_;
+};
+
+#endif
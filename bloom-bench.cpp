@@ -0,0 +1,77 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
+#include "bench_utils.h"
+#include "avlbst.h"
+
+using namespace std;
+
+// AVLTree::find() with and without the Bloom filter, when most lookups miss.
+//
+// usage: bloom-bench [entries] [lookups]
+//
+// The tree holds the even keys below 2 * entries; 60% of the lookups ask for odd keys,
+// which are never present. One lookup in a hundred is followed by removing a key and
+// inserting another, so the filter goes stale and is rebuilt after entries / 32 removes.
+
+static const size_t BITS_PER_KEY[] = { 0, 4, 8, 10, 16 };
+
+static void run(size_t n, size_t lookups, size_t bitsPerKey)
+{
+	mt19937 rng(47);
+	vector<int> keys(n);
+	for(size_t i = 0; i < n; i++) keys[i] = (int)(2 * i);
+	shuffle(keys.begin(), keys.end(), rng);
+	AVLTree<int, int> tree;
+	for(size_t i = 0; i < n; i++) tree.insert(make_pair(keys[i], (int)i));
+	tree.setBloomFilter(bitsPerKey, n / 32);
+
+	size_t hits = 0, next = 0;
+	Stopwatch watch;
+	for(size_t i = 0; i < lookups; i++)
+	{
+		int key = 2 * (int)(rng() % n) + (rng() % 10 < 6 ? 1 : 0);
+		if(tree.find(key) != tree.end()) hits++;
+		if(i % 100 == 0)
+		{
+			// swap a present key for an absent even one past the original range
+			tree.remove(keys[next % n]);
+			tree.insert(make_pair(keys[next % n] + 2 * (int)n, 0));
+			keys[next % n] += 2 * (int)n;
+			next++;
+		}
+	}
+	double secs = watch.seconds();
+	if(hits == 0) cerr << "no hits" << endl;
+
+	BloomFilterStats stats = tree.bloomFilterStats();
+	if(bitsPerKey == 0)
+	{
+		cout << "  no filter" << endl;
+		cout << "    lookups/s:          " << (uint64_t)(lookups / secs) << endl;
+		return;
+	}
+	cout << "  " << bitsPerKey << " bits per key, " << stats.hashes << " hashes" << endl;
+	cout << "    lookups/s:          " << (uint64_t)(lookups / secs) << endl;
+	cout << "    false positives:    " << (double)stats.falsePositives / (stats.rejected + stats.falsePositives) << endl;
+	cout << "    filter bytes:       " << stats.bits / 8 << " (" << (double)stats.bits / n << " bits per entry)" << endl;
+	cout << "    rebuilds:           " << stats.rebuilds << endl;
+}
+
+int main(int argc, char *argv[])
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+	size_t lookups = argc > 2 ? strtoul(argv[2], NULL, 10) : 4000000;
+	if(n < 32)
+	{
+		cerr << "usage: " << argv[0] << " [entries >= 32] [lookups]" << endl;
+		return 1;
+	}
+
+	cout << "AVLTree<int,int> with " << n << " entries, 60% of lookups missing" << endl;
+	for(size_t b = 0; b < sizeof(BITS_PER_KEY) / sizeof(BITS_PER_KEY[0]); b++)
+		run(n, lookups, BITS_PER_KEY[b]);
+	return 0;
+}
@@ -5,440 +5,45 @@
 
 using namespace std;
 
+// Quick sanity check of the trees. For performance numbers use the bench target.
 
 int main(int argc, char *argv[])
 {
-	
-	int data[5000] = 
-			{
-				2902, -19757, 19389, -15484, 24642, 7850, 1634, 
-				16149, -11289, -24107, -23561, 17349, 12481, 19186,
-				16851, 10548, 17919, -165, -9937, -2812, 946, -1922, 
-				-10439, 5221, -403, 2151, 24564, -20486, -9836, 22578, 
-				-8709, 13858, -22419, -310, 7099, -9878, -16471, -7471, 
-				12537, 5539, 5405, 12299, -12889, -10809, -15466, 13616, 
-				11072, 7292, -720, -8182, -2779, 15788, 21817, 17900, -9409, 
-				7824, -2473, 16424, -8300, 23904, -12905, 8210, -20892, 19114,
-				21316, 20473, -11567, -5877, 970, -11731, -18578, -19092, 4324,
-				14671, 9414, -24984, 16906, 17629, 1568, 17537, -19084, 5396, 
-				-24624, 13777, -23306, 11141, -8997, 9627, 9595, -3938, -1857, 
-				6591, -15895, -4121, 1352, -12697, 19374, -9357, -16232, 14996, 
-				-23785, -2196, 21517, 21233, -12659, -24365, -7781, 7442, 11895, 
-				5613, 17561, -24116, -9844, 15774, -17844, 14729, 23060, 11242, 
-				-10998, -14106, 6295, 7224, 10002, -7293, 5761, -829, 7049, -10150, 
-				11768, -24479, -9062, -24549, -21825, -10022, -2836, -92, -8677, 
-				-7327, 13450, 11033, 15991, -18898, -7583, -18426, -384, 10545, 
-				14125, 19873, -5996, 2983, 5749, 11476, 22980, -17871, 8380, 
-				16908, 784, -12817, -2482, 6646, -21355, -23531, 2178, -24512, 
-				-11385, 9395, -17912, 31, 16512, 5681, 10568, 8822, 3385, 24117, 
-				17637, 11123, -18242, 5671, 353, -10417, 20888, 12853, 7291, 6627, 
-				20029, 4169, -10269, -17053, 6636, 16256, -15195, 17573, -22745, 
-				-20536, -24131, -20354, -5566, 18823, 11104, 12386, -5034, -6011, 
-				6671, -4651, -4529, 9758, 24773, 4585, 6195, 1362, -24741, -24082, 
-				-1709, 12981, 3249, -4518, 6658, 4949, -7960, 22867, 21352, -14544, 
-				-11593, 18590, 11411, -24415, -14196, -5790, 10752, 21545, -1291, 
-				23860, -3299, -20562, -3728, 13613, -2512, 22491, 22703, 4291, 
-				-16999, -9051, 3377, 17136, 7638, 1167, -17957, -18713, 1824, 
-				-14639, -16738, -14467, 22531, 4373, 23571, 5378, -12733, 23313, 
-				1447, -5388, 12914, 13985, -18498, -11552, -6216, -6907, -18438,
-				1325, -23454, -2948, -3479, -22421, 19787, 18549, -21436, -4125, 
-				-22814, 7787, -7225, 16947, -23099, -958, 4216, -18974, 16527, 
-				10049, -17373, -20558, -18931, -23121, -7195, -3070, 14977, -22426, 
-				-898, 4661, -7922, 15690, 8447, 16666, -7587, -3042, -20870, 486, 
-				-16699, -4393, -14465, 3503, 2596, -10278, -4985, -8011, -17267, 6448, 
-				2256, -7947, 864, 6240, -5271, 16082, 5160, 6878, -11003, -15695, 921, 
-				19127, -15211, -823, 342, -16326, -23909, 6809, 5512, 913, 20960, 11145, 
-				-21030, -12736, 10313, -16737, 24892, 11876, -16408, 9056, 23263, 14430, 
-				-18626, 5081, -17538, 667, -4738, -5307, 3880, 4956, 2128, -6269, 9874, 
-				23192, 1220, -5979, -24871, -19288, -1825, -5274, 9016, 14741, -24840, 
-				17228, 16990, -87, -8678, 22155, -10393, 1500, 13015, -17515, 22633, 
-				5597, -7629, -22964, -18525, 58, 21719, 1048, 4715, -7842, -19451, -14812, 
-				-8702, 24200, 712, 5751, 15038, 23252, 16853, -20733, 11645, 23107, 11513, 
-				3622, -6554, -1300, -12368, 9847, -20825, 12050, 15873, -3280, 103, -15857, 
-				-5424, 18578, -1268, -13962, -6612, -5151, -21378, 9265, -15017, -20570, 
-				1863, -1992, 6956, 13330, 7117, -10566, 24885, -9230, -17647, 17462, 
-				-23971, 16130, -699, -1982, -10538, 9950, -18012, 20169, 1676, 17530, 1262, 
-				-22046, -22941, -19308, -5224, 5387, -12061, -17999, -10236, 11136, 7331, 
-				-20002, -2475, 5322, 3758, -11012, -12079, -3503, -5843, -18741, -15734, 
-				18861, -12904, 17023, 12046, -12093, 18141, -40, -19469, -8087, -774, 132, 
-				10404, 14773, -20654, 4024, -23468, -14821, 21630, 9036, 21831, 19005, 
-				16683, 24027, -6862, 9445, 23133, -289, 10280, 9390, 13836, 16122, -24390, 
-				9474, 4922, -21878, 7940, 4121, -16939, 5573, 11860, 22466, 6670, 7024, 
-				-4445, 24898, -4989, -2584, -14140, -16384, -10643, 18178, -4577, -23166, 
-				-3928, 23841, -6366, -924, -20989, -5446, -15939, 12361, -4552, 6557, 13130, 
-				-2647, -6440, 9781, 11600, -8322, -12656, 10193, -4174, 13550, 20313, 8131, 
-				1699, 23577, -23033, 24017, 7517, 4853, 13781, 22955, 18530, -1895, -8998, 
-				-1435, -2992, -19440, 19122, -23461, -18326, -19166, 12039, -22782, 12381, 
-				23171, -11576, -18038, 22641, 10099, 21607, 8785, 18428, -20436, -11214, 5395, 
-				16343, 763, -22771, -19398, -10471, -9840, -9837, 1920, 11871, -14914, 8260, 
-				8349, 14349, -13125, -9094, -4645, -21925, 1612, 17446, 12303, 17219, -19606, 
-				-3881, 15866, 4800, -4071, 10808, -23156, -20410, -19795, -17936, 10362, -15023, 
-				-23368, 17326, -12523, -24395, -9402, 3677, 8153, 4952, 4917, -1285, -9766, 
-				14025, -22429, -7695, -8730, -17023, 15373, 6167, 18680, 19712, -109, -16619, 
-				2760, -15238, 18432, 11305, -18581, 1992, 2801, -4417, 6822, 2165, 18167, -5265, 
-				14481, -15370, 23601, 16336, -1169, -6237, 9698, -13403, -18057, -7981, -11703, 
-				-18509, -21532, -17601, -10863, -18018, -13549, -1106, -141, 2335, 4906, 4618, 
-				11041, 1631, 917, -6497, 8841, -19450, 14896, 14486, -18739, -17492, -21367, 
-				-17069, -2303, -23159, 17213, 22203, -12949, -21700, 23492, -5418, 16438, 4816, 
-				-9393, 4707, -20386, -8882, 15469, 23410, -7110, 22792, 23272, 6655, 8083, 8716, 
-				8558, 11206, 18231, 9150, 4005, -23856, 23947, -2923, 22909, 24093, 9909, 22012, 
-				-13373, -24647, 631, -10745, -24974, 6628, -13808, 17297, -10755, 20743, -5447, 
-				20498, -12106, 5645, 1004, 14011, 2162, -9415, 2992, -17628, -18363, 7584, 22216, 
-				-10228, 5289, 16073, 5831, -19554, -152, 2272, -11137, -9531, -9414, 20181, 12211, 
-				862, 5190, 20721, 6729, -12908, 1272, -24459, -20057, 2809, 20659, -4432, 21849, 
-				-1046, -17996, 7982, 21976, 22882, -13339, 16131, -22842, 11541, 22385, -23997, 
-				-198, -17466, 10204, -16078, 16801, -8825, 9708, -2390, -4481, 7265, -3194, -23891, 
-				20452, -2831, -17670, -4061, 18561, -8315, 23150, 1566, -23429, 17998, 6817, -700, 
-				16413, 9163, 4565, -23051, 17112, -14651, 5787, 21094, 12742, 14670, -7423, -23642, 
-				-1321, -24285, -1726, -16740, -15441, -24330, -22739, -19961, 11217, -8667, 11095, 
-				20467, 19984, -18598, -17682, -322, 6068, -8384, -8704, 19527, -17417, 15311, 4170, 
-				5298, -16025, -21112, -9636, -1021, 23257, 14915, 24857, -2481, 21043, -7683, -374, 
-				4843, -4360, 5794, -13947, -17192, -12351, -15951, 9735, 12213, 16623, 6616, -21987, 
-				-18182, -12190, 4512, 3278, 7544, -149, -5646, 23602, 8901, 1849, 13181, -2010, 23495, 
-				15862, 635, 3223, 313, 3672, -11071, -24228, 2336, -2037, -10924, -5191, 10601, -305, 
-				23728, 954, 1652, -6061, -90, -7980, 18980, 5903, 5309, -6787, -12316, 19836, 17711, 
-				6677, 6855, 20905, -20028, 20755, -23331, 5492, -20576, -23780, 23389, 14441, 13428, 
-				5054, 7709, -4776, -13491, 5056, -17055, 7837, 10124, -21770, 23334, -20781, 21486, 
-				8934, -21504, 15528, 10270, -1165, 20308, -4784, -2273, -24895, 11425, 2641, -18616, 
-				20507, 14102, 22734, -3550, 17979, -14062, -9283, 23497, -18983, 9165, -22118, -20307, 
-				11100, -10132, 18032, 1624, -9153, 24969, -6278, 8010, -19303, -13895, -8100, 7287, 
-				21360, -6325, 20663, -9254, -2091, -24041, 23456, 2124, -933, 16480, 22232, -16512, 
-				4571, 11070, -23899, -13320, 20360, -8946, -279, -6403, 20318, -23771, -19135, -9140, 
-				6218, -3611, 9788, -12655, 13549, -18687, 20123, 11544, -6163, -16262, -5107, -2454, 
-				2136, -19527, -20330, -8495, -24739, -16681, -10580, 21809, -13041, -13216, -6603, 
-				13057, -13902, -20345, -8567, 18414, 22007, 12086, -18988, 1137, -12066, 17825, 
-				15372, -23374, -24833, -11988, -22526, 1958, -18416, -5540, -20041, 11894, 24818, 
-				10183, 2733, 23721, 3665, -14209, 20022, -20717, -19835, -10123, 17869, 6266, 
-				13601, -13675, -21669, -15886, 4935, 8585, 18806, 16261, 6205, -2378, 2071, 
-				-18374, -9956, 17101, 22521, 6193, -18969, -11311, -18026, 2755, 18323, 15792, 
-				-20958, 19943, -24370, 16875, 24460, 12769, -23222, 1331, 9871, -4449, -182, 
-				15494, 14135, 13427, 9816, -2962, -23854, 4648, 11654, 17115, 15412, -23728, 
-				14338, 22904, -2528, 19421, -24494, -276, 22768, -12165, -16586, -9604, 10148, 
-				3591, -6153, -18556, 14251, 410, -2150, -4760, -9957, 9799, 20593, 11320, 
-				-16526, 24301, 12893, 4651, 1419, -17876, -14756, -7822, -7817, -19890, 9081, 
-				7545, 633, -4322, -7525, -13123, -3241, 18994, -19911, 10292, 22575, 2907, 
-				-5919, -682, -5243, -19844, 22527, -2990, -20544, -18309, -9524, 8316, -22207, 
-				-12069, 9229, 19335, -10359, -20349, 9801, 76, -6492, -7699, -13976, 14059, 
-				-12702, -21120, 15937, 23182, 3289, 23950, -14445, -851, 22214, -1231, 17007, 
-				-2411, 2712, 2988, 11299, 4416, 1155, 4653, -3270, -12623, 11113, -17351, 
-				-20924, 3251, -7704, 24557, -13057, 23640, -12003, 19860, -8592, -13596, -7610, 
-				16467, -5567, -18034, -11302, -11740, 8826, 9740, -20795, 17313, -945, -13728, 
-				12811, 24775, -5149, -7557, -13488, -16959, -15777, -19717, 12325, 21928, -14412, 
-				9501, 12479, -10772, 9421, 14591, 21235, 23400, 11598, 16968, -17201, -11319, -18344, 
-				-22718, -7464, 4353, -1351, -10326, -6430, 22504, 5704, -6049, 16398, -22615, -13970, 
-				12414, -20651, -13500, 18237, -16088, 9790, 6862, 15742, 11108, -21553, -4369, 2512, 
-				-4962, -4293, 3983, 23689, -21583, 7558, -20573, -12174, -24449, -2735, -18083, -17422, 
-				-7621, -2794, 10923, -20890, 1129, -19514, -14184, 14648, 12998, 11114, 8442, 24609, 
-				-4292, 16635, 19310, 24559, 10410, -7946, -5519, 9528, 15535, -16546, -3590, -1375, 
-				-14088, -19948, 22516, 18592, 18069, -2978, 9685, 3222, 24314, 12085, -4366, -14968, 
-				4496, -15971, 3033, -18422, -23101, -16736, -19726, -6285, -6476, 23227, -18310, 8368, 
-				-15127, -14216, 23481, -12880, 18863, 20947, 23945, 18357, 4871, 12294, 18714, 16106, 
-				7121, -7258, 10255, -15782, 15998, 24390, 5288, 154, -1199, -3424, 23896, 15158, 5847, 
-				-15272, 16917, 9076, -18365, 24384, 2118, 10747, 13929, 24733, 10663, -18059, -16719, 
-				-5350, 24452, -22593, -15894, -16854, 15018, 21580, -974, 20935, -12235, 7942, -20308, 
-				24608, -7603, -20914, -2679, 19016, -18233, 7576, 5161, 24625, 15641, 11641, 20196, 
-				15561, 4009, 4110, 23480, 2920, -10020, -18765, 21149, 20059, 2296, 12172, -12304, 4108, 
-				-15684, 20017, 19175, 12374, -4259, 9776, 20414, 18964, 21870, -19338, -4480, -17293, 
-				-4655, -19276, 18276, -18785, -2626, 52, -17857, -23324, -5673, 15506, -21472, 8343, 
-				15407, 24547, -19545, 1593, 15753, 12209, -3310, 19361, 10882, -15599, 7134, 15689, 
-				20379, -3309, -18496, -13988, -14224, -7969, 4720, 3531, -9724, 3944, -192, -21642, 
-				-11057, 16766, 7735, -20919, -19003, -1339, -11347, -13149, -20278, -17888, 11610, 
-				-3695, -6187, -20827, -441, -16204, -2477, 19902, -17036, -21575, -12148, 21842, 12526, 
-				-16098, -22111, 14423, 6748, -16082, -16073, 134, 20361, -8282, 20539, -21983, 1016, 1752, 
-				-13161, 4936, 10609, -20881, -22416, 5366, 7839, -7911, -19754, -21732, 1291, -14708, 
-				625, 12292, -11105, -5802, -21412, 5313, 3136, -13070, -22762, -18895, -21549, -20215, 
-				19596, 3009, -8895, -3157, -6273, 16892, 15650, -10931, 3100, -3584, -18280, 10809, 23651, 
-				-17823, -6136, 21285, 13306, 2442, -8480, -13446, -11159, -18468, 522, -2286, 832, 14027, 
-				18235, 2866, -420, 6872, 5531, -24393, -13157, -18601, -55, 24333, 16125, -1803, 24649, 
-				21126, 14459, 4864, -24534, 6105, 12344, 16465, 8433, -1006, 6145, 4164, -13765, 11754, 
-				4754, -947, 8578, -22146, 6674, -23847, -3120, -22596, 12559, -12091, -22256, 20324, 
-				11001, -7037, -12267, -1011, 7893, -6327, 10419, -20317, 18304, -22462, -555, 17720, 
-				-24962, 5648, -19259, -16684, -8150, -15664, -13608, -4192, -15344, 14993, 5425, 21547, 
-				-3591, -568, 7001, -15758, -3932, -2513, -1866, 6147, -21453, -19929, -7269, -7715, 21761, 
-				11702, -16712, 1370, 5931, 24575, 11260, -16291, -9236, -5616, 8573, 2436, -8925, -15407, 
-				-10144, 16660, -14557, 1621, -10513, -11986, -20607, 1112, -8590, -7746, 13692, 4842, 6180, 
-				11298, 1596, 18685, 5674, 4234, -13603, 1789, 24269, -19953, -8547, -1561, 22873, 9131, 
-				-21269, 5521, 22087, -11661, 11047, -7496, -15281, 10324, -10185, 3859, -2157, -21766, 
-				-23776, -1041, -5874, 24845, 22477, -21933, -21832, -16819, 8429, -8139, 22045, -16966, 
-				23736, 13096, 13052, 11614, 940, -1778, -5706, -18308, 21481, -19927, 17197, -13201, 7374, 
-				-11394, -22781, -13820, 1153, 16569, 24265, -706, 22705, 8803, 19024, 22803, 9659, -2201, 
-				-10064, -6256, -5141, 19575, 15960, -21554, -12012, 16303, 18054, 5352, -15784, 20713, 
-				16991, 5908, -14957, -22653, -7058, -4574, 733, -21114, 1648, 21695, -1005, 10990, -9100, 
-				13674, -10807, -12029, 18638, -11155, -21873, 21320, -3742, 13989, 16488, 741, -4957, 
-				-8483, -16578, 15181, 3074, -21380, 20477, -22402, 7259, -15740, 17621, -21194, -161, 
-				9802, -12794, 21470, -6441, 20342, 306, -15437, 10343, -9123, -2188, 8919, 14268, 1252, 
-				2580, -17521, -20519, -21390, -16456, -16664, -17103, 12049, -609, -9435, -17248, 11002, 
-				6041, 7274, -1630, 3739, -12680, 10451, 13012, -1389, 17918, -22658, -9611, -1913, 18874, 
-				4677, 11226, -19007, 7808, -14099, -10343, 2603, 20295, 18225, 11286, 15936, 8626, 23282, 
-				17347, 21334, 1258, 22423, 4027, 2479, -19464, -18145, -10030, 2481, 17547, 17655, -5591, 
-				5030, 17707, 7575, 17788, -14253, -10711, 2645, 6927, 16226, -6054, 21502, 7179, 19403, 
-				7762, -17395, 23539, -11845, -8057, -12452, 9562, -10673, -5161, -21311, -21266, -12172, 
-				14828, 12832, 5583, -23791, -2640, -16653, -24209, -19155, -19012, 14824, 18926, -19906, 
-				15963, 3469, -20863, 567, 12622, 23466, -19727, 15297, 8069, 18637, 15253, -2578, 18446, 
-				16022, -581, 20619, -4601, 23054, 11215, -10833, -22590, -14666, -16181, 16033, 21862, 20866, 
-				-16600, -19498, 23445, -8049, -8240, -16657, -18159, 14314, -12289, -882, -22675, 11776, 2985, 
-				-14982, -3396, 5549, -7306, -7874, -19385, 16708, 9745, -23257, 12875, 1967, -9297, 18171, 15724, 
-				4635, -13530, -18558, -6468, 953, -13272, 3426, 6016, -15774, 7385, 22307, -8455, -3073, 23141, 
-				-13091, 10968, 23168, 5748, 5094, 14021, 17407, -8562, 16324, 23795, -7329, 21916, -9482, -2402, 
-				-1900, 23163, -24547, -2620, 381, 22571, -5120, 12855, 16446, -12793, 22797, 1998, -11887, 
-				9609, 21602, 12160, 19438, 14501, 22204, 24250, -13022, -21385, 7165, 19789, 3615, -9282, 
-				3774, 9279, -8036, 11239, -21818, -18990, 2891, -22740, 19355, -4621, 10113, -14993, 14450, 
-				-6574, -18596, 1673, -21298, 7878, -1166, 1329, 20871, -22917, 12963, 10961, -18178, -5282, 
-				-19665, -1088, -14364, 110, 9317, -2217, -10058, -8771, -19353, 16235, -13238, 11902, 7856, 
-				-16759, 20089, 6004, -22896, 16974, -23277, 12118, -17550, 3034, 14130, 24162, -24088, 645, 
-				5948, -5663, -5774, -1223, -23164, 11077, -9045, -286, -3517, -22792, 4944, -24622, -13417, 
-				-17583, 18229, -17357, -14935, -1740, 18899, -12033, -12051, 6815, 3172, 24099, -666, 20833, 
-				-1485, 12968, 18499, -21225, -14932, -16128, -16889, -15386, 19332, 16445, -1283, 2505, -23281, 
-				12621, 22035, 5344, 14509, -12105, 15175, 7923, -14606, -12826, 9750, -10186, 22143, 9407, -6165, 
-				14918, -14773, -13352, -5380, 8344, -11834, 4413, -18647, -15143, -13390, -1903, -5256, -19322, 
-				24334, 13500, 1239, -2864, -12035, 20348, -3485, 23357, 23800, -20912, 4739, 7129, -11992, -12411, 
-				19100, 21417, -23320, -23029, 18347, -8653, 23386, -4112, 15911, -6337, -13641, 18101, 6234, 24724, 
-				-9687, -10277, 5868, -16881, -2569, 18107, -14368, 12713, -15515, -5426, 13360, -24103, 11796, 3964, 
-				-23291, -18033, -13989, 22826, -18992, -5745, -7515, -21029, -2085, -16467, 18686, 13333, -7469, 
-				16297, 2466, -8028, 15940, -6677, 1154, -21341, -18109, 7615, 1670, -11959, -23477, -9241, -8170, 
-				4664, 2832, -15220, -24079, 18776, 6222, 16377, -11036, -12347, -3645, 6968, 15729, -529, -2243, 
-				-18839, -21588, -11550, 13241, -14037, -2708, -21415, -14847, -20957, -7959, 17572, -18860, 5305, 
-				-14919, -16295, -11220, -22122, 3860, 11080, -23894, 20005, -6847, 23837, -17740, -7494, -11178, 
-				22117, -197, -7231, -7068, -22995, 12685, -7571, 21548, -16912, -16632, 20749, -11393, 13593, 
-				-22308, 3115, -3076, 9084, -13047, -7970, 11965, 13830, -16145, -18688, 17699, 17188, -4884, 
-				20547, -6988, -4103, -21157, -1302, 23376, -12161, -2050, 6820, 20744, 471, 9622, -13972, 815, 
-				-3221, -8844, -6888, 23976, -21151, -11422, -5601, 13387, 17879, -7619, -11675, -22108, 22182, 
-				-4921, -23150, 6898, 8175, -13315, 21283, 3522, 11222, -13664, 2380, 14172, -21454, 23264, 
-				-8119, -3216, 8983, 14971, 17044, -14025, -19651, 6395, -13569, 17531, -21244, -14554, 605, 
-				-24171, -12428, -22388, 22311, -24385, -7163, -1651, -1815, 16928, 16120, -14483, -19772, 
-				-6887, 13245, 9188, -19193, -20665, 1754, -23877, 634, -13455, -11488, -3140, -24015, 12728, 
-				-16800, 7659, 24792, 13732, -23624, -5788, 15106, -24713, 16994, 15321, 6386, 11856, -20606, 
-				17334, 11696, 14990, 23656, -22694, 6439, -4348, 12057, 2586, -14428, 12198, -15208, -9503, 
-				-10321, 15899, -3417, -12218, -20237, -8006, 8411, -736, -5167, -5134, -14198, -23532, -14366, 
-				-21207, 6378, -2074, -17560, -12284, -5392, -7077, 17971, 19903, -17851, 2446, 8000, -3317, 
-				-11505, -9451, 13260, 2085, 2252, 2243, 16127, 2982, -21886, 8649, 18496, -309, 886, 12636, 
-				496, 19211, -7685, -7878, 9025, 11653, 15954, -4793, -21204, -16340, -16235, 10534, 13823, 
-				-18621, -17282, -10758, 4545, -16917, 3022, -15539, 24422, -1176, -20565, -12801, 18464, -19891, 
-				-12374, -17995, 242, -21993, 5864, -2682, -2705, 4770, 16470, 12764, -6206, 3589, -13118, 16090, 
-				11552, 5319, -6904, -15829, -7854, -2310, 15250, -21118, 18088, -3826, -81, -16686, -23620, -5007, 
-				-8158, -7633, -11915, 13040, -20641, -7717, 5793, 11011, -21751, -10138, 16227, 21673, -21617, 
-				-2508, -15739, 759, -14853, -14876, 22936, -16648, -21396, 14502, -4781, -812, -11530, -14839, 
-				-607, -22903, 6212, -23710, 8520, -12410, 4724, -1503, 8793, 23059, -11015, 24499, -14974, -17311, 
-				19862, -16767, 12660, -24394, -16554, -16703, -13683, -12010, 18895, -11192, 7144, 19347, 583, -349, 
-				14390, -5512, 9359, -12946, -4837, 23474, 6398, -16156, 9815, 18912, -15727, -7938, 14039, -24769, 
-				-13632, 7807, 3669, -17199, -19732, 18037, 5920, -12301, -11403, 4058, 12952, -14899, -419, 4825, 
-				16300, -21845, 14431, 15222, -1928, 4150, -17399, -13211, 13475, 11612, 15143, 21221, -16900, -5808, 
-				362, 19840, -1770, 19083, -22561, 16097, -20648, 13446, 11258, -8673, 23983, 5913, 17434, 11334, 
-				-13381, -17946, 15346, -21678, -16724, -7381, 9237, -14603, -1158, 5874, -19603, 17087, -19642, 
-				6047, -3774, -24337, -7064, -4788, -2681, -23481, 5893, 18407, -12268, 20482, 22777, 11879, -13444, 
-				4038, -4053, 19742, 18416, 22150, -6392, -6623, -15909, 18397, 7947, -24735, 6662, -17421, 14710, 17116, 
-				9299, 2921, 1126, -11260, -9732, 16063, 7510, -8487, 24066, 20423, 18365, -21438, -19793, -21362, 1969, 
-				6297, -2300, 9477, 19634, -22024, -15771, -12229, -1565, -5506, -21518, -3069, 14193, 17460, 9049, 18309, 
-				-2338, -20081, 157, 22221, 15589, -3338, 15030, -16980, -8896, -11534, -20096, 11502, -13995, 8265, 6601, 
-				-20860, -20299, -11480, 904, 24708, 22333, 18932, -11597, 4294, 16532, -14743, 17401, -7332, 18593, -11121, 
-				15152, -23675, -10133, 2430, 4152, 17921, -765, 10954, -20646, -11062, 1385, 24746, 374, 12272, 12287, 
-				-15888, 24221, 293, 23709, 13757, 16747, 1996, -24717, 2032, -2702, -24045, -15411, 17209, 6165, -6177, 
-				16585, -11708, -15057, -14721, 6465, -6611, 307, -14240, -3909, 3724, 13268, -4437, -8840, -24994, 700, 
-				15294, -24944, 16001, -4935, -24089, 10730, -2511, 19146, 16378, -16256, -12783, 17557, -8172, -4851, 9586, 
-				-11955, -11212, -9192, -6480, -22148, -4623, 4066, -3541, 12483, 11481, -6585, 7483, -20758, -6993, 7704, 
-				-6272, -16000, -19477, -19851, -1661, -13166, 23932, 11583, -20991, -4805, -8963, 24243, -1189, -17238, 
-				-5142, -14505, 7968, -9302, -21565, -19780, 19757, 6559, -17379, -20426, -19968, 7305, 2471, 9007, -1397, 
-				2905, -24809, 21601, 20306, 7598, 14726, -22218, -23385, -21668, 14715, -22489, 24987, 12499, -11156, -6951, 
-				13431, -1032, 18648, 10013, 20665, 11542, 13466, -16760, -24433, -4275, -21480, 19805, 7549, -22979, 23674, 
-				6614, -7162, -13194, -13555, 429, -20351, 2772, 22120, 14120, 4062, 3934, 6171, -21326, -21232, 16946, -12639, 
-				8956, -16282, 623, 7751, -11649, 3845, -15904, 1087, 8134, -6990, 12619, -11463, 2457, 21811, 13521, 2001, 
-				-19199, 13543, -12564, -1114, 24744, 1275, -14513, 20323, -15594, 21637, 13219, 24526, -12897, 4428, -17277, 
-				-19875, 1009, 10409, -6408, 9625, 7454, -9429, -8968, -11330, -6459, -2438, -23059, -14716, 4109, 5198, -429, 
-				20002, 8595, -19147, 18858, 10279, -21441, 6249, -21887, 8602, 273, -15058, 15402, -23186, -21190, -20970, 
-				17244, -24219, 12297, 1238, 989, -10173, 2112, 24120, -20921, -4745, 24091, 17844, 8082, -3259, 762, 19470, 
-				-22107, 3329, 20381, -20293, -21715, -8217, -11416, 8839, -22360, -4526, -7540, -10102, -2738, 17614, 18855, 
-				-19354, -23079, -14908, 11729, 16341, 23471, -23267, 9402, -9931, -12375, -206, -18850, 3600, -9735, 19914, 
-				-15287, -19789, 5001, -13734, 3546, 13791, -23052, 24234, 16019, 15798, -21147, 18021, -15997, -19456, 115, 
-				-19657, -14748, 20394, 12910, 14936, 1314, -3659, 8631, 8396, -2128, 3574, -15680, 4011, 8870, -1869, 20923, 
-				-955, -8816, -971, 13695, 12433, -23192, 24508, -588, -241, -16142, 11868, 4874, 18864, -20865, -10218, -5345, 
-				835, 2686, -770, 2281, -9162, 19073, 20370, 20776, 17593, 2398, -23173, 14346, 12000, -386, -8128, 6914, 1830, 
-				-12651, -24854, 1554, 10392, 22763, -14508, 10446, -4100, 24580, -6845, 22513, -8325, -95, -16787, -4801, -6200, 
-				6238, -12477, -7531, 5097, -9769, -23441, -16332, 888, -17498, 9976, -3739, 4542, 11761, -15303, 418, 11842, 7945, 
-				-21273, 9151, -527, -12666, -11352, -13809, -18124, 15130, -5378, -1288, 8537, -5045, 19812, 2543, -4060, -22073, 
-				-1518, 3257, 11216, 5026, -17405, 4514, 8106, 8879, 11984, -13630, 4268, 20158, 20269, -17178, -227, -19846, -18434, 
-				-14383, -2033, 19558, -18387, -2629, 6566, 7936, -18557, 17774, -11337, 18992, 23586, 3061, -13652, -23410, -18040, 
-				3062, 16594, 6478, 24185, 3398, -4408, 2932, 20385, -20313, -13613, -22830, 12214, -20250, -24526, -22963, 21477, 
-				22363, 22744, -10907, 4941, 19710, 19700, 4498, -7245, 13678, 1792, 18869, -16958, 5980, -1715, -24989, 5033, 4163, 
-				-4205, -24746, 3539, 11307, 24693, -15630, -19863, 16775, -16174, 24888, 10907, -4903, -23957, 15393, 12404, -19345, 
-				-14751, -19537, -19893, 18320, -3914, 11580, 21954, -8012, -11964, -23674, 7010, -3051, -23041, -9314, 5122, -16644, 
-				1564, 5576, 17092, -1178, -10374, 19839, -172, -18906, -14160, 12465, 21330, 22137, -13637, -5795, 21656, -15920, -6286, 
-				-19113, -13686, -13291, 4927, 19629, 21016, -3568, 6631, -7684, -3030, -5121, -20636, -5048, -15849, -12378, 4782, 
-				15199, 9943, 3164, -12536, 5647, -17973, 13768, 24206, 1767, 11813, 9012, 17073, -21288, -7706, -19460, -19944, 
-				14318, -15548, -20230, -3725, -20954, -18575, -20192, 17223, 5147, 2836, 7726, 12672, 10698, -2263, 13801, -18640, 
-				-8255, 3826, 22456, 21472, -5618, 3668, 18667, 17542, 23067, 18234, 13462, 4564, -16474, -13568, -22820, 12478, 
-				11026, 13595, -6076, 13563, -3126, -19788, 12920, -12464, 22023, -5572, -4808, 7009, 18280, 5825, -3873, 2477, -7567, 
-				1122, -17133, -2561, -23691, 8757, -7191, -21866, -10604, 1072, 18431, -9597, 8177, -12645, -11109, -24865, -11423, 
-				11632, -9342, 16855, -8350, 6755, 1580, -10898, 1851, -8155, -7909, -18972, -15906, 10453, -9405, -22182, 22074, 5186, 
-				-1885, -11231, -11692, 18177, 23832, 19761, 15838, 12493, -4749, -12993, 23205, 14920, -14271, 4515, -2984, -8741, 
-				22832, 23478, -6429, -24380, -2946, -19861, 11821, -14040, -7489, 14505, -394, -1926, -18789, -2579, -22962, -15064, 
-				22702, -558, 14151, -22813, -16312, -13088, -12388, 21132, -12120, 12814, -14575, -24810, 1010, -22947, -1447, 7102, 
-				10185, -2899, -2611, 18868, 2143, -5448, 20535, -5724, -4011, 22063, -19009, 13564, 3875, -18563, 942, 16394, 15646, 
-				24972, 22111, -18852, 5158, -1662, 1766, 22195, 18607, 11681, 2960, 1015, -21146, -18759, 6660, 4895, 10132, -4329, 
-				-24653, -12103, -21529, -16656, -6770, -9454, -8783, 4210, -3473, 1065, 23496, -12517, -23358, 13082, -8831, 8246, 
-				9849, 7169, -20131, -12225, 19506, -20948, 23873, -11430, -732, -13268, 14764, 19605, 7323, 2437, 21731, -17556, 
-				136, 6734, 23956, -19737, -17567, -24681, -16253, -14078, -20301, -1036, -7200, -11022, 6834, -22185, 4595, 3276, 
-				11844, -9340, -15744, -2494, 18403, -9154, -19327, -8393, 24864, 5173, -17474, -2939, -4680, -12966, 16044, 11001, 
-				-18854, -16816, -10569, 23990, 18957, 24387, -13787, -11720, -19663, -20470, 21855, 8792, 14930, 5911, -15674, 
-				-7166, -12156, 14702, -16962, 16140, -19236, -11816, 8672, -11866, -22403, 3232, -5969, 10702, -23027, 6701, 
-				-3820, 20957, 7935, -6039, 1062, 14183, -22609, -22869, 1515, -15776, 18736, -11200, 5031, -9715, -13198, -6547, 
-				-5677, 22932, -670, -12457, -6025, 15476, 13227, -22597, 23754, 23684, 10349, -4020, -15678, 7343, -2532, -5201, 
-				-19124, -16583, -10966, 20470, 19831, 21723, 3797, 10775, 12074, -14750, -4585, 16304, -3994, 13005, -5032, 23921, 
-				-7454, 564, 15822, 8809, 11629, 4047, -9428, 24807, -6765, 6412, -13770, 6208, -4941, -4362, 18668, 5479, 24437, 
-				-17193, -19118, -20725, 15310, -5441, -10736, -18414, -20679, -6260, 22146, 18090, 6821, 14580, -9565, -2389, 
-				-23743, 6007, -12088, 12699, 1429, 12180, 1170, 20392, 15835, 19133, 3242, 24836, -1423, 19872, -12940, -10004, 
-				4518, -2431, 14790, -14047, -24541, -20580, -8745, 17211, 11087, -5854, -14325, 2132, 11564, 24177, -18615, -10804, 
-				-10756, 18344, 17036, 6605, -22713, 24063, -9270, -18925, -9803, -20995, 20840, -8961, -9190, 18119, 10355, -23849, 
-				18145, -16324, 2838, 18424, 24006, -13266, 6825, 2718, -11443, 20070, 2650, -10248, 20277, -23538, -5276, 2189, 
-				-3691, 8405, -3225, -23444, 19777, 10653, -16919, -13963, -19182, -628, 23793, -18949, 13076, -9439, 22024, 20326, 
-				11199, -16817, 11398, -21776, -22326, 21918, 15854, 10151, 24504, -19287, 1680, 7952, -3813, 7515, -18156, 15266, 
-				11623, -4928, 23978, 8856, -21790, -17151, -23133, -5136, -18343, -22886, -7916, 18209, -4440, -13693, -14163, 
-				17817, -6682, 23157, -369, -17333, 18581, -621, 17321, -13573, 4753, 5336, 15330, 9883, -13560, 17403, 5586, -5695, 
-				13546, 24202, -13207, 3351, -5784, -1720, 10778, -3929, 21783, 6311, -24743, -943, 19222, 1226, -18382, 5139, 6845, 
-				13837, -18211, -8244, -16336, -8734, 3366, 12706, 19514, 5975, -17613, -20167, 15445, 4437, -24125, -5188, 1717, 
-				-22113, -18250, 5517, 22783, 4035, -8433, 10301, 8548, 16829, -21947, 4694, -918, 1208, -15025, 23106, -24724, 24668, 
-				373, 12367, 7461, -10081, -23229, 21539, -5058, 23874, 1705, -22667, -10502, 19856, -4168, 12024, -12633, 4675, 1630, 
-				-3865, 10799, 11324, 3199, -3789, -981, 9411, -19197, 6860, 2915, -9333, 24218, -3696, 6578, 11158, -12306, -11068, 
-				4331, -5075, -23833, 171, 12136, 20938, 2709, -1831, -20590, 7379, -15928, 14386, -13871, 23433, -7038, 8184, -8330, 
-				-24884, -18767, -6880, 23202, -10891, -663, 18950, -21756, -13368, 12922, -780, -2469, -2043, -20836, 24622, 22353, 
-				-9684, 3594, -14533, 9686, 4030, 2127, -21078, 6309, 4312, -4448, 4389, -5526, -12892, -1256, 10880, 17099, 12778, 
-				-1484, 2035, -8207, -23020, 15935, 15343, 12203, -16313, -13502, -9426, -16150, -24419, 17910, 6900, 14587, 804, 17499, 
-				12410, 23538, 17860, -916, 5765, -20933, 12311, -19463, -17438, -24842, 611, 8470, 4912, 3581, 10817, -9034, 16886, 2177, 
-				-22899, 7200, -8866, -2239, 6046, -7255, -18169, 20994, -17447, -13472, 7147, -11509, -20440, 6948, -15789, -229, -10705, 
-				10125, -1588, -22180, 3914, -13633, -2315, -6983, 20532, -22656, -22922, -12197, 24833, 17785, 22591, 15892, 13115, 23040, 
-				16607, -13011, 2000, 2449, 11451, -23012, 4544, -21883, -1961, -6154, 18954, -14746, -6358, 12531, 22445, 1975, -22817, 
-				3882, -13362, -3785, 18409, -23340, 4183, 4258, -13940, 8771, -20875, 780, 108, -21868, 1518, 11880, -8820, -21748, 22754, 
-				14879, -7109, -23646, 1985, -10164, -14352, -23730, 9371, -3033, 8800, -13025, -24725, -18879, 17503, -6760, -5464, 8731, 
-				-23435, 4099, 19594, 371, -9883, -4826, -22194, 15901, 14891, 6149, 13498, -1197, 4664, 13169, 18100, -16960, 15039, 7765, 
-				-13538, -1766, -18542, 9614, -11032, -7906, -19716, 1492, -21153, 18717, -24281, 8378, 24335, -5455, 2373, -21002, 2690, 
-				12459, -7896, 6511, 4006, -618, 14700, 6707, -19254, 14900, 3920, 10429, 15370, 23740, -24922, 15133, 15956, -12576, 
-				19706, -8274, -5535, 22864, 11533, 18328, 22812, 15300, 16998, 1989, -3142, 19655, 24332, -18628, -647, 11996, 9660, 
-				-5980, -22091, 16072, -6386, 17097, -24753, 13090, -6114, 23781, 4338, -23937, -13778, -7636, -13723, -137, 22537, 
-				18574, 13632, 557, -23837, 19992, 11364, -12898, 11397, 15420, 3971, 13994, 15284, -18899, 18156, 21323, -15724, 
-				14190, -2798, -11433, 2064, -10983, 9771, 16094, -5729, -17712, 5593, -14679, 1854, -22652, -15201, -2882, 15890, 
-				-19296, -23035, 16190, -17504, -22383, -17952, 15048, -1087, -3483, 7391, -874, -19021, 10614, -17305, -23203, -7250, 
-				19979, -8648, 19791, 14865, 19434, 6312, 2886, -24317, 24404, -6134, -6137, 14283, 5500, 20518, -15672, 3999, 9343, 
-				21992, -20122, -10275, -336, 24611, -6015, 24383, 16091, 7664, 3864, 5854, 10018, -11699, 19019, -8849, 19747, 3302, 
-				19723, -2557, 24855, 3495, -8625, -127, -1289, 14711, -10298, 23322, 873, -13139, 1768, 7196, 7334, -23819, 10198, 
-				12809, -20793, 9791, 12980, -1355, 21531, 13304, -21733, -20117, -22444, 506, -21689, 17240, 19728, -17704, 23590, 
-				22366, -17168, -301, 3730, 22841, -8456, -12385, 1606, 15329, -4775, 10438, 20209, 13158, -6517, -6538, -18778, 
-				-13739, 1856, 22822, 12912, -24782, 23794, -23629, 10953, 1870, -21538, -17551, -12499, -22728, 2693, 4421, -7288, 
-				20270, -18861, -4740, 23743, 7253, 3064, 20775, 22368, -1003, -12614, 7571, 9774, 12663, 16311, 22213, 618, 9748, 
-				-2470, -18300, 5689, -13576, 2889, 11359, 8475, -12571, 15820, 19695, 1721, 19165, 24050, -2827, 9786, -5587, 2225, 
-				-20540, 15699, -13248, -23453, 16716, 2741, 16159, 7296, -10648, 18352, 23225, -2137, -6981, -16476, 3863, 9547, 
-				21833, 23401, 7042, -1669, -13205, -2038, 22499, 16257, -12842, 1351, 2840, 21203, -998, 7881, -3915, -8874, 11528, 
-				-4412, 14872, -21609, 13123, 19725, -21544, 24172, 305, -22409, 4621, 15004, -8852, 24030, 22928, 5985, 21648, 23292, 
-				-24350, -17317, 6706, 18211, 14627, -10389, -24665, 2201, -3324, -23235, -15608, -7559, 22239, 8572, -5005, -23303, 
-				-8581, -23475, 11852, 1483, -13769, -19207, 22406, -78, 22286, 15831, -6032, 20524, 12176, 21823, 5858, 2095, -10786, 
-				-7201, 13980, 3321, -20421, -12877, -20035, -3793, 14447, -8489, -3024, 14245, 22757, -8288, 17559, 8607, 6805, 23380, 
-				24311, -5328, -10118, -6853, 23554, -10175, -7419, -22957, -2700, 17281, -19404, 9966, -1841, -17965, 24814, -3403, 
-				21837, -11112, 8859, 12669, 7509, -10157, 1935, 23999, -19599, 295, 10668, -3556, -1421, -11131, -11755, -20142, 23675, 
-				10792, -1994, -13991, -5630, -17756, 4969, -225, 12753, -4925, -20407, 24327, 21868, -3091, -21758, 3472, 6804, -24617, 
-				-3277, -1573, 3165, 12496, 8391, -20484, 13447, 18506, 21388, -3063, 261, 19616, -22027, 16999, -17038, -1342, -1873, 14643, 
-				14768, 24283, 15110, -13960, -5173, 17610, -11459, 18354, -24738, -16016, -4088, -1973, 3094, 22654, 21139, 8016, 
-				-24273, -14075, 20716, -16558, 20268, 17102, 6330, -21052, -23473, -20618, 14688, -23682, -4194, 17077, -3456, 
-				1042, 1723, 18008, -21071, -6614, -2565, -7025, 20970, 10339, -21719, 19627, 5175, 1180, 12970, -11965, -10811, 
-				-20775, 4646, -11538, 21509, -5050, -7652, 4680, 7044, 20937, 15477, 22142, 15087, 2333, 19386, 5096, -7740, 
-				11494, 2768, 19097, -17954, 9723, -13129, -17893, 24415, -4734, 12168, -21499, 4410, -17464, 18219, 18672, 
-				-2384, -11513, -23341, 14192, 20761, -6652, -17284, -18896, -2028, 18408, 5697, 23713, 3359, -9763, 19849, 
-				13276, -16765, -18912, 1124, -3451, -16129, 3138, 17104, 11904, 4814, 3454, -5819, -11611, -3307, 23425, 24038, 
-				-16416, 15107, -12281, 4141, 18839, 5355, -17384, -10715, -13459, 9164, -7185, 21588, 9851, -12488, -17479, 
-				17227, -16649, 7848, -18465, -16143, 12569, -9897, -14269, 7526, 12394, 14940, 14357, -5223, -16234, 4915, 
-				-19704, -10340, -18279, -4129, 24797, 2065, -20109, 11171, 9632, 3566, 2626, -13061, 19818, 13414, 15069, 
-				23084, -5160, -8801, 19107, 18712, -10953, 5093, 9826, 7562, 22458, 3800, 17107, -22366, 4641, -22078, 
-				-14954, -23348, -10292, -20856, 2135, 4239, 1993, -616, -23289, 22027, -20224, 9199, 23162, -24991, -22096, 
-				2899, -2016, 12757, 1712, 5277, -11297, -18341, 11656, -16516, 5629, 21462, -21620, 3815, 4456, 13733, 9888, 
-				5800, 24002, 19124, -7232, -10879, 16061, -4872, -4014, 21464, -12009, -24296, -11273, -10638, -22678, 23394, 
-				9330, -14398, 538, 20763, 24060, 13390, 19044, 18007, -3043, 11575, 2073, -5086, -12292, 9052, -10952, -18037, 
-				-21822, 3287, -758, -16112, -2710, 14537, -13060, 4933, -761, -9121, 21482, 15077, -12199, -16690, -19371,
-				7228, -15095, -6101, -13667, 16533, -3898, -21450, -20001, 9520, 9023, 6489, 6470, -15943, -9761, -6819, 2639, 
-				-3803, 2285, 12732, -5730, 12442, 22544, 7499, -33, 1008, 1613, 19190, 1987, 14586, 6688, 9837, 18404, -719, 
-				-16059, -5375, -4563, 21044, -15269, -2458, 8127, 17323, 19300, 10247, -5955, 24365, 11872, 19251, 16849, 15757, 
-				-4054, -20761, -16997, 1063, -12198, 12254, -5131, -18504, 9160, 16800, -19670, 10385, 19946, -1634, -6961, 
-				-22735, 16291, 24024, -5092, -7042, -2885, -3830, 4354, 2082, 21263, 3603, 2269, -21229, 13993, -19937, 14090, 
-				2887, 14065, -24100, -2173, -9720, 4886, -23733, -9187, 16076, -13577, -8889, -7703, -1567, 23123, -14547, 584, 
-				24528, -24235, -3623, -5805, 14396, 7607, 9833, 19501, 8041, 11923, -13138, 16925, 1513, -19208, 5427, 21351, 
-				-7337, -13006, 20436, -20305, 10879, -6221, 15837, -14691, -3457, -5731, -4856, -5228, 7058, -20450, 17483, 
-				9425, 4403, 7256, -10565, -24939, -10961, 8191, -11369, -23547, 18448, -17858, 9387, 19331, -18881, -21740, 
-				-22284, -17596, -22707, 18158, -18457, -5903, 276, -9386, -18045, -23317, 9038, -9693, -24451, -3973, 22430, 
-				18834, 3852, 13821, 10922, -20174, 11987, 829, -6035, 4395, 8252, 10235, 24403, 11893, 15588, 12850, 6592, -5620, 
-				-22758, -19671, 12934, -3912, 3267, 8460, -2527, 15118, 10703, -24081, -7261, 23147, -21676, 15460, 17105, -23445, 
-				-20476, -13467, 1285, 7482, -4269, -24649, -15565, 16253, -4533, -20415, -15455, 2462, 22237, 11459, -20442, 21685, 
-				4683, -6846, -8873, 5310, -10078, -12981, -5067, 5106, -24696, -21134, 24193, -9057, 20145, 24205, -13066, -2281, 
-				18892, 8190, -19262, 20187, 19174, 19928, 16535, -5059, -12589, 14076, -24885, 2791, -8359, 7715, 5204, 9645, 8993, 
-				-24142, 2625, -8921, -6399, -9383, 17651, -10950, 9296, -5154, 14827, 3658, 10705, 14605, 18361, -8766, 8450, 19983, 
-				-24557, 16265, 7927, -24747, 14259, -7739, -5242, 1718, 9795, -13699, 6833, 13050, 10704, 1625, 24728, 24918, 15184, 
-				-8549, 4788, -16305, 7612, 20128, -1301, 7489, 23109, 10506, 18695, -9952, 3047, -3183, 18350, 1978, 20638, 22992, 
-				-22700, 16930, 14526, 128, -4505, -21631, -24346, 6376, -9017, 1547, 2242, -14684, 6718, -2879, 13881, -19855, -22508, 
-				-17902, -1491, -13498, 14776, -6107, -11566, -17070, 23778, 4342, -14401, 12838, 13642, 18538, -19213, 2399, 17642, 
-				-3660, -17068, -11264, 16459, 14840, 11823, -15830, 17358, -23517, 263, 4494, 6126, 13547, 8481, -7092, 21505, -1513, 
-				-1441, 10513, -2077, 8297, -20530, -2415, -19683, -7372, 9088, -15648, -2335, 1320, -22104, 22697, -10028, 6293, 16452, 
-				23369, -24949, -15934, -24907, 24345, -23718, 16544, 1383, -23421, 2040, -10176, 19603, -6059, 5248, 20911, 10558, 7569, 
-				-21592, 8452, 12544, 5833, -6815, 24591, -20510, -11748, 11410, -14345, 9351, -5683, 5128, -6448, -1326, 15246, -19059, 
-				-19709, -9976, -6233, 20462, -7216, -23999, -23502, 4647, -22136, 2416, -4911, -17035, -21647, -16725, -580, -23731, 10690, 
-				-18433, 8579, 14234, -14815, 24109, -7867, -14977, 14517, -16869, -5990, -11292, 24588, 6033, 24518, 11784, -9788, 17359, 
-				-8463, 20066, -4080, -3625, 21405, 6894, -3383, -23167, 5040, 1805, 7539, 8824, -14798, 18603, -242, -21633, 2425, -11452, 
-				22, -4878, -24202, -21233, 18833, 9212, 9752, -24267, 4918, 21279, -15583, -22973, 5108, 9581, -17181, -21180, -22092, 4289, 
-				-24095, -13819, -2087, -5351, 1559, 8505, 8092, -24097, -14635, 2685, 1039, -177, -951, -6335, -12116, -22262, -3375, -16824, 
-				-16626, 19483, 14760, 6981, -7881, 9884, -462, -17752, 7586, 8250, 4327, 5907, -6732, -16258, 11263, 441, 20036, 15342, -3388, 
-				7554, 23058, 3416, 3652, 18103, 22365
-			};
-	AVLTree<int, char> at;
-	AVLTree<int, char> bt;
-
-	// for(int i=0; i<5000; i++)
-	// {
-	// 	if(data[i]==-19651)
-	// 	at.debugTime();
-	// 	at.insert(std::make_pair(data[i], '.'));
-	// 	if(data[i]==-19651)
-	// 	at.debugTime();
-	// }
-	for(int i=0; i<50; i++)
-	{
-		bt.insert(std::make_pair(i, '.'));
-		bt.print();
-	}
-
-	// bt.print();
-
-
     // Binary Search Tree tests
-    // BinarySearchTree<char,int> bt;
-    // bt.insert(std::make_pair('a',1));
-    // bt.insert(std::make_pair('b',2));
+    BinarySearchTree<char,int> bt;
+    bt.insert(std::make_pair('a',1));
+    bt.insert(std::make_pair('b',2));
     
-    // cout << "Binary Search Tree contents:" << endl;
-    // for(BinarySearchTree<char,int>::iterator it = bt.begin(); it != bt.end(); ++it) {
-    //     cout << it->first << " " << it->second << endl;
-    // }
-
-
-    // if(bt.find('b') != bt.end()) {
-    //     cout << "Found b" << endl;
-    // }
-    // else {
-    //     cout << "Did not find b" << endl;
-    // }
-    // cout << "Erasing b" << endl;
-    // bt.remove('b');
-
-    // // AVL Tree Tests
-    // AVLTree<char,int> at;
-    // at.insert(std::make_pair('a',1));
-    // at.insert(std::make_pair('b',2));
-
-    // cout << "\nAVLTree contents:" << endl;
-    // for(AVLTree<char,int>::iterator it = at.begin(); it != at.end(); ++it) {
-    //     cout << it->first << " " << it->second << endl;
-    // }
-    // if(at.find('b') != at.end()) {
-    //     cout << "Found b" << endl;
-    // }
-    // else {
-    //     cout << "Did not find b" << endl;
-    // }
-    // cout << "Erasing b" << endl;
-    // at.remove('b');
+    cout << "Binary Search Tree contents:" << endl;
+    for(BinarySearchTree<char,int>::iterator it = bt.begin(); it != bt.end(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+    if(bt.find('b') != bt.end()) {
+        cout << "Found b" << endl;
+    }
+    else {
+        cout << "Did not find b" << endl;
+    }
+    cout << "Erasing b" << endl;
+    bt.remove('b');
+
+    // AVL Tree Tests
+    AVLTree<char,int> at;
+    at.insert(std::make_pair('a',1));
+    at.insert(std::make_pair('b',2));
+
+    cout << "\nAVLTree contents:" << endl;
+    for(AVLTree<char,int>::iterator it = at.begin(); it != at.end(); ++it) {
+        cout << it->first << " " << it->second << endl;
+    }
+    if(at.find('b') != at.end()) {
+        cout << "Found b" << endl;
+    }
+    else {
+        cout << "Did not find b" << endl;
+    }
+    cout << "Erasing b" << endl;
+    at.remove('b');
 
     return 0;
 }
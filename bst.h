@@ -5,6 +5,13 @@
 #include <exception>
 #include <cstdlib>
 #include <utility>
+#include <ostream>
+#include <vector>
+#include <algorithm>
+#include "bst_stats.h"
+#include "bst_profile.h"
+#include "bst_trace.h"
+#include "bst_cache.h"
 
 /**
  * A templated class for a Node in a search tree.
@@ -186,6 +193,25 @@ void Node<Key, Value>::setValue(const Value& value)
   ---------------------------------------
 */
 
+/**
+* Limits for BinarySearchTree::exportDot() and exportJsonLines() (see export_bst.h).
+* The defaults export the whole tree.
+*/
+struct TreeExportOptions
+{
+    TreeExportOptions() : maxDepth(0), sampleRate(1.0), seed(0) { }
+
+    // deepest level exported, the root being level 1; 0 for no limit
+    int maxDepth;
+    // chance that each subtree below the root is exported, between 0 and 1
+    double sampleRate;
+    // seeds the sampling, so exporting the same tree twice gives the same output
+    uint64_t seed;
+};
+
+template<typename Key, typename Value>
+struct ParallelPiece;
+
 /**
 * A templated unbalanced binary search tree.
 */
@@ -197,11 +223,60 @@ public:
     virtual ~BinarySearchTree(); //TODO
     virtual void insert(const std::pair<const Key, Value>& keyValuePair); //TODO
     virtual void remove(const Key& key); //TODO
-    void clear(); //TODO
+    virtual void clear(); //TODO
     bool isBalanced() const; //TODO
     void print() const;
     bool empty() const;
 
+    // Snapshot of the calling thread's operation counters plus the current height.
+    // The counters stay zero unless compiled with -DBST_STATS (see bst_stats.h).
+    TreeStats stats() const;
+    void resetStats();
+
+    // Height, size, leaf depths and balance factors, measured in one O(n) pass.
+    TreeProfile profile() const;
+
+    // Records this tree's operations to trace (see bst_trace.h); NULL stops tracing.
+    // The tree does not take ownership. Iterators step through the tree's current
+    // writer, so once tracing is stopped the writer may go before they do.
+    void setTrace(TraceWriter<Key>* trace);
+
+    // Remembers the node each key find() and operator[] found in a direct-mapped table
+    // of slots entries (rounded up to a power of two) and checks it before searching;
+    // 0 turns it off. Also zeroes lookupCacheStats(). With the cache on, even const
+    // lookups write to it, so they must not run on several threads at once.
+    void setLookupCache(size_t slots);
+    LookupCacheStats lookupCacheStats() const;
+
+    // Keeps a Bloom filter of the keys, sized for bitsPerKey bits per key (0 turns it
+    // off), so find() and operator[] can turn away most missing keys without touching
+    // a node. Inserts add to it; removes cannot take keys out, so once
+    // rebuildAfterRemoves of them have happened (0 for never) the next lookup rebuilds
+    // it from the tree, as it does when the tree outgrows it. Also zeroes
+    // bloomFilterStats(), and like the lookup cache it makes const lookups write to the
+    // tree. Key must have a std::hash, since equal keys have to set the same bits.
+    void setBloomFilter(size_t bitsPerKey, size_t rebuildAfterRemoves);
+    BloomFilterStats bloomFilterStats() const;
+
+    // Stream the tree as a Graphviz digraph, or as one JSON object per node, without
+    // recursion and in O(height) memory (see export_bst.h).
+    void exportDot(std::ostream& out, const TreeExportOptions& options = TreeExportOptions()) const;
+    void exportJsonLines(std::ostream& out, const TreeExportOptions& options = TreeExportOptions()) const;
+
+    // Calls fn(std::pair<const Key, Value>&) on every entry, from threads threads at once
+    // (0 for one per hardware thread) working on separate subtrees (see parallel_bst.h).
+    // The order of the calls is unspecified, and the tree must not change meanwhile.
+    template<typename Fn>
+    void parallelForEach(Fn fn, unsigned threads = 0) const;
+    // Folds every entry into a copy of identity with fold(T&, std::pair<const Key, Value>&),
+    // one copy per piece of the tree, then merges the copies with combine(T& into,
+    // const T& from). When ordered they are merged in key order, so combine need not be
+    // commutative; otherwise each thread first merges its own pieces' copies, on that
+    // thread. Either way combine must leave a T unchanged when handed an untouched copy
+    // of identity.
+    template<typename T, typename Fold, typename Combine>
+    T parallelReduce(const T& identity, Fold fold, Combine combine, unsigned threads = 0, bool ordered = false) const;
+
     template<typename PPKey, typename PPValue>
     friend void prettyPrintBST(BinarySearchTree<PPKey, PPValue> & tree);
 public:
@@ -225,6 +300,9 @@ public:
         friend class BinarySearchTree<Key, Value>;
         iterator(Node<Key,Value>* ptr);
         Node<Key, Value> *current_;
+        // the tree's writer slot, set when the tree was being traced as this iterator
+        // was made; read on every step, so setTrace(NULL) stops the recording
+        TraceWriter<Key>* const *trace_;
     };
 
 public:
@@ -246,15 +324,57 @@ protected:
     // Provided helper functions
     virtual void printRoot (Node<Key, Value> *r) const;
     virtual void nodeSwap( Node<Key,Value>* n1, Node<Key,Value>* n2) ;
+    // Balance factor (right height minus left height) kept in n, for trees that store one.
+    virtual bool nodeBalance(const Node<Key, Value>* n, int& balance) const;
+    void exportTree(std::ostream& out, const TreeExportOptions& options, bool dot) const;
+    // An iterator at n, traced like the ones find() returns, and the node an iterator
+    // is at; for derived trees' queries.
+    iterator iteratorAt(Node<Key, Value>* n) const;
+    static Node<Key, Value>* iteratorNode(const iterator& it);
+    // internalFind() through the Bloom filter and the lookup cache, where they are on
+    Node<Key, Value>* lookupNode(const Key& key) const;
+    // lookupNode() in two halves, for trees that search their own way: screenLookup()
+    // returns false if the filter turns key away, else true with key's cached node in
+    // n, or NULL in n when the tree must be searched; finishLookup() is handed what
+    // that search found, caches it and returns it.
+    bool screenLookup(const Key& key, Node<Key, Value>*& n) const;
+    Node<Key, Value>* finishLookup(const Key& key, Node<Key, Value>* n) const;
+    size_t cacheSlot(const Key& key) const;
+    // Every tree calls rememberKey() when it creates a node, and forgetNode() just
+    // before deleting one, to keep the filter and the cache current. nodeSwap() moves
+    // nodes without changing their keys, so neither needs to hear about it.
+    void rememberKey(const Key& key);
+    void forgetNode(Node<Key, Value>* n);
+    // tests (or sets) key's bits in the filter, and refills it from every key in the tree
+    bool bloomTest(const Key& key, bool set) const;
+    void rebuildBloom() const;
+    // the node after n in a preorder walk, through the parent pointers
+    static Node<Key, Value>* nextPreorder(Node<Key, Value>* n);
+    // cuts the tree into pieces for parallelForEach() and parallelReduce(), in key order
+    void cutForParallel(unsigned threads, std::vector<ParallelPiece<Key, Value> >& pieces) const;
 
     // Add helper functions here
-		static int height(const Node<Key, Value>* n);
-		static bool balanced(const Node<Key, Value>* n);
     Node<Key, Value> *getBiggestNode() const; 
 
 protected:
     Node<Key, Value>* root_;
     // You should not need other data members
+    TraceWriter<Key>* trace_;
+    // the lookup cache: empty when off, else a power of two of slots indexed by the
+    // top bits of the key's mixed hash, i.e. shifted right by cacheShift_
+    mutable std::vector<Node<Key, Value>*> cache_;
+    mutable LookupCacheStats cacheStats_;
+    int cacheShift_;
+    // the Bloom filter: empty when off. bloomKeys_ counts the keys added since the last
+    // rebuild, bloomCapacity_ how many the array was sized for, and bloomRemoves_ the
+    // removes since the last rebuild.
+    mutable std::vector<uint64_t> bloom_;
+    mutable BloomFilterStats bloomStats_;
+    mutable size_t bloomKeys_;
+    mutable size_t bloomCapacity_;
+    mutable size_t bloomRemoves_;
+    size_t bloomBitsPerKey_;
+    size_t bloomRebuildAfter_;
 };
 
 /*
@@ -271,6 +391,7 @@ BinarySearchTree<Key, Value>::iterator::iterator(Node<Key,Value> *ptr)
 {
     // TODO
 		current_ = ptr;
+		trace_ = NULL;
 }
 
 /**
@@ -281,6 +402,7 @@ BinarySearchTree<Key, Value>::iterator::iterator()
 {
     // TODO
 		current_ = NULL;
+		trace_ = NULL;
 }
 
 /**
@@ -339,6 +461,7 @@ BinarySearchTree<Key, Value>::iterator::operator++()
 {
 	// std::cout<<std::endl << "****" << std::endl << "ITERATOR" <<std::endl<< "Key " << current_->getKey() << std::endl;
 	// TODO
+	if(trace_!=NULL && *trace_!=NULL) (*trace_)->recordNext();
 	// We don't need to go up the tree, just return successor
 	if(current_->getRight()!=NULL)
 		current_ = successor(current_);
@@ -451,6 +574,10 @@ BinarySearchTree<Key, Value>::BinarySearchTree()
     // TODO
 		//  std::cout << "In constructor" << std::endl;
 		root_ = NULL;
+		trace_ = NULL;
+		cacheShift_ = 0;
+		bloomKeys_ = bloomCapacity_ = bloomRemoves_ = 0;
+		bloomBitsPerKey_ = bloomRebuildAfter_ = 0;
 }
 
 template<typename Key, typename Value>
@@ -487,7 +614,9 @@ template<class Key, class Value>
 typename BinarySearchTree<Key, Value>::iterator
 BinarySearchTree<Key, Value>::begin() const
 {
+    if(trace_ != NULL) trace_->recordBegin();
     BinarySearchTree<Key, Value>::iterator begin(getSmallestNode());
+    if(trace_ != NULL) begin.trace_ = &trace_;
     return begin;
 }
 
@@ -510,11 +639,26 @@ template<class Key, class Value>
 typename BinarySearchTree<Key, Value>::iterator
 BinarySearchTree<Key, Value>::find(const Key & k) const
 {
-    Node<Key, Value> *curr = internalFind(k);
-    BinarySearchTree<Key, Value>::iterator it(curr);
+    BST_STATS_OP(TREE_OP_FIND);
+    if(trace_ != NULL) trace_->record(TRACE_FIND, k);
+    return iteratorAt(lookupNode(k));
+}
+
+template<class Key, class Value>
+typename BinarySearchTree<Key, Value>::iterator
+BinarySearchTree<Key, Value>::iteratorAt(Node<Key, Value>* n) const
+{
+    BinarySearchTree<Key, Value>::iterator it(n);
+    if(trace_ != NULL) it.trace_ = &trace_;
     return it;
 }
 
+template<class Key, class Value>
+Node<Key, Value>* BinarySearchTree<Key, Value>::iteratorNode(const iterator& it)
+{
+    return it.current_;
+}
+
 /**
  * @precondition The key exists in the map
  * Returns the value associated with the key
@@ -522,14 +666,18 @@ BinarySearchTree<Key, Value>::find(const Key & k) const
 template<class Key, class Value>
 Value& BinarySearchTree<Key, Value>::operator[](const Key& key)
 {
-    Node<Key, Value> *curr = internalFind(key);
+    BST_STATS_OP(TREE_OP_FIND);
+    if(trace_ != NULL) trace_->record(TRACE_FIND, key);
+    Node<Key, Value> *curr = lookupNode(key);
     if(curr == NULL) throw std::out_of_range("Invalid key");
     return curr->getValue();
 }
 template<class Key, class Value>
 Value const & BinarySearchTree<Key, Value>::operator[](const Key& key) const
 {
-    Node<Key, Value> *curr = internalFind(key);
+    BST_STATS_OP(TREE_OP_FIND);
+    if(trace_ != NULL) trace_->record(TRACE_FIND, key);
+    Node<Key, Value> *curr = lookupNode(key);
     if(curr == NULL) throw std::out_of_range("Invalid key");
     return curr->getValue();
 }
@@ -545,11 +693,14 @@ void BinarySearchTree<Key, Value>::insert(const std::pair<const Key, Value> &key
 {
 		// TODO
 		//  std::cout << "In insert func" << std::endl;
+		BST_STATS_OP(TREE_OP_INSERT);
+		if(trace_!=NULL) trace_->record(TRACE_INSERT, keyValuePair.first);
 		// no tree at all
 		if(root_ == NULL)
 		{
 			// std::cout << "\tinsert root" << std::endl;
 			root_ = new Node<Key, Value>(keyValuePair.first, keyValuePair.second, NULL);
+			rememberKey(keyValuePair.first);
 			// print();
 			return;
 		}
@@ -564,8 +715,11 @@ void BinarySearchTree<Key, Value>::insert(const std::pair<const Key, Value> &key
 		}
 
 		temp = root_;
+		int depth = 1;
 		while(temp->getLeft()!=NULL || temp->getRight()!=NULL)
 		{
+			BST_STATS_VISIT();
+			BST_STATS_COMPARE(1);
 			// need to enter left subtree
 			if(temp->getKey()>keyValuePair.first)
 			{
@@ -578,10 +732,13 @@ void BinarySearchTree<Key, Value>::insert(const std::pair<const Key, Value> &key
 				if(temp->getRight() == NULL) break;
 				temp = temp->getRight();
 			}
+			++depth;
 		}
+		BST_STATS_DEPTH(depth + 1);
 
 		// if we made it out we are at a leaf
 		Node<Key, Value>* n = new Node<Key, Value>(keyValuePair.first, keyValuePair.second, temp);
+		rememberKey(keyValuePair.first);
 		if(temp->getKey()>keyValuePair.first)
 			temp->setLeft(n);
 		else 
@@ -615,14 +772,17 @@ void BinarySearchTree<Key, Value>::remove(const Key& key)
     // TODO
 		//  std::cout << "In remove func to remove " << key << std::endl;
 		// print();
+		BST_STATS_OP(TREE_OP_REMOVE);
+		if(trace_!=NULL) trace_->record(TRACE_REMOVE, key);
 		Node<Key, Value> * to_remove = internalFind(key);
 
 		if(to_remove==NULL) return;
 
-		if((to_remove==root_) && (height(root_) == 1))
+		if((to_remove==root_) && (root_->getLeft()==NULL) && (root_->getRight()==NULL))
 		{
 			// std::cout << "\tidentified root" << std::endl;
 			root_ = NULL;
+			forgetNode(to_remove);
 			delete to_remove;
 			return;
 		}
@@ -722,6 +882,7 @@ void BinarySearchTree<Key, Value>::remove(const Key& key)
 
 		// if(to_remove->getParent()->getLeft() == to_remove) to_remove->getParent()->setLeft(NULL);
 		// else  to_remove->getParent()->setRight(NULL);
+		forgetNode(to_remove);
 		delete to_remove;
 		// std::cout << "is print failing?" << std::endl;
 		// if(root_!=NULL){
@@ -775,17 +936,36 @@ template<typename Key, typename Value>
 void BinarySearchTree<Key, Value>::clear()
 {
     // TODO
-		//  std::cout << "In clear func" << std::endl;
-		Node<Key, Value>* temp = getSmallestNode();
-		// if(temp!=NULL && temp==root_) temp = getBiggestNode();
+		// delete bottom-up through the parent pointers: every edge is walked once
+		// each way, so this is linear and needs no recursion or rebalancing
+		Node<Key, Value>* temp = root_;
 		while(temp!=NULL)
 		{
-			// delete temp;
-			remove(temp->getKey());
-			temp = getSmallestNode();
-			// std::cout << "what the hell is happening????????" << std::endl;
-			if(temp == NULL) return;
-			// if(temp!=NULL && temp==root_) temp = getBiggestNode();
+			if(temp->getLeft()!=NULL) temp = temp->getLeft();
+			else if(temp->getRight()!=NULL) temp = temp->getRight();
+			else
+			{
+				Node<Key, Value>* parent = temp->getParent();
+				if(parent!=NULL)
+				{
+					if(parent->getLeft()==temp) parent->setLeft(NULL);
+					else parent->setRight(NULL);
+				}
+				delete temp;
+				temp = parent;
+			}
+		}
+		root_ = NULL;
+
+		for(size_t i = 0; i < cache_.size(); i++)
+		{
+			if(cache_[i] != NULL) ++cacheStats_.invalidations;
+			cache_[i] = NULL;
+		}
+		if(!bloom_.empty())
+		{
+			std::fill(bloom_.begin(), bloom_.end(), 0);
+			bloomKeys_ = bloomRemoves_ = 0;
 		}
 }
 
@@ -834,10 +1014,15 @@ Node<Key, Value>* BinarySearchTree<Key, Value>::internalFind(const Key& key) con
 		
 		if(root_==NULL) return NULL;
 		Node<Key, Value>* temp = root_;
+		int depth = 1;
 		while(temp->getLeft()!=NULL || temp->getRight()!=NULL)
 		{
 			// std::cout << "around and around we go :D" << std::endl;
+			BST_STATS_VISIT();
+			BST_STATS_DEPTH(depth);
+			BST_STATS_COMPARE(1);
 			if(temp->getKey() == key) return temp;
+			BST_STATS_COMPARE(1);
 			if(temp->getKey() > key)
 			{
 				if(temp->getLeft()==NULL) return NULL;
@@ -848,8 +1033,12 @@ Node<Key, Value>* BinarySearchTree<Key, Value>::internalFind(const Key& key) con
 				if(temp->getRight()==NULL) return NULL;
 				temp = temp->getRight();
 			}
+			++depth;
 		}
 
+		BST_STATS_VISIT();
+		BST_STATS_DEPTH(depth);
+		BST_STATS_COMPARE(1);
 		if(temp->getKey() == key) return temp;
 		return NULL;
 }
@@ -863,31 +1052,309 @@ bool BinarySearchTree<Key, Value>::isBalanced() const
     // TODO
 		//  std::cout << "In is balanced func" << std::endl;
 		// print();
-		return balanced(root_);
+		return profile().balanced;
+}
+
+/**
+* Returns this thread's counters along with the tree's current height.
+*/
+template<typename Key, typename Value>
+TreeStats BinarySearchTree<Key, Value>::stats() const
+{
+    TreeStats snapshot = bstThreadStats();
+    snapshot.height = profile().height;
+    return snapshot;
+}
+
+/**
+* Measures the tree's shape with an iterative post-order walk that keeps one frame per
+* level, so a health check costs O(n) time and O(height) memory even on a degenerate tree.
+*/
+template<typename Key, typename Value>
+TreeProfile BinarySearchTree<Key, Value>::profile() const
+{
+    // a node on the path from the root to the node being visited
+    struct Frame
+    {
+        const Node<Key, Value>* node;
+        int depth;
+        // children handled so far: 0, 1 (left) or 2 (both)
+        int visited;
+        int childHeight[2];
+    };
+
+    TreeProfile result;
+    std::vector<Frame> path;
+    uint64_t leafDepthSum = 0;
+    int minLeafDepth = 0;
+
+    if(root_ != NULL)
+    {
+        Frame root = { root_, 1, 0, {0, 0} };
+        path.push_back(root);
+    }
+
+    while(!path.empty())
+    {
+        Frame& top = path.back();
+        if(top.visited < 2)
+        {
+            const Node<Key, Value>* child = top.visited == 0 ? top.node->getLeft() : top.node->getRight();
+            ++top.visited;
+            if(child != NULL)
+            {
+                Frame next = { child, top.depth + 1, 0, {0, 0} };
+                // top is invalidated by the push
+                path.push_back(next);
+            }
+            continue;
+        }
+
+        int left = top.childHeight[0];
+        int right = top.childHeight[1];
+        int depth = top.depth;
+        int height = 1 + (left > right ? left : right);
+        int balance = right - left;
+
+        ++result.size;
+        ++result.balances[balance];
+        if(balance < -1 || balance > 1) result.balanced = false;
+        if(left == 0 && right == 0)
+        {
+            ++result.leaves;
+            leafDepthSum += depth;
+            if(result.leafDepths.size() <= (size_t)depth) result.leafDepths.resize(depth + 1, 0);
+            ++result.leafDepths[depth];
+            if(depth > result.maxLeafDepth) result.maxLeafDepth = depth;
+            if(minLeafDepth == 0 || depth < minLeafDepth) minLeafDepth = depth;
+        }
+
+        path.pop_back();
+        if(path.empty())
+        {
+            result.height = height;
+        }
+        else
+        {
+            // the side just finished is the last one the parent visited
+            Frame& parent = path.back();
+            parent.childHeight[parent.visited - 1] = height;
+        }
+    }
+
+    if(result.leaves > 0) result.averageLeafDepth = (double)leafDepthSum / result.leaves;
+    result.equalPaths = minLeafDepth == result.maxLeafDepth;
+    return result;
+}
+
+/**
+* Zeroes this thread's counters.
+*/
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::resetStats()
+{
+    bstThreadStats() = TreeStats();
+}
+
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::setTrace(TraceWriter<Key>* trace)
+{
+    trace_ = trace;
+}
+
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::setLookupCache(size_t slots)
+{
+    cacheStats_ = LookupCacheStats();
+    cache_.clear();
+    if(slots == 0) return;
+
+    // at least two slots, so the shift stays below 64
+    int bits = 1;
+    while(((size_t)1 << bits) < slots) ++bits;
+    cache_.assign((size_t)1 << bits, NULL);
+    cacheShift_ = 64 - bits;
+    cacheStats_.slots = cache_.size();
+}
+
+template<typename Key, typename Value>
+LookupCacheStats BinarySearchTree<Key, Value>::lookupCacheStats() const
+{
+    return cacheStats_;
+}
+
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::setBloomFilter(size_t bitsPerKey, size_t rebuildAfterRemoves)
+{
+    static_assert(LookupCacheHasStdHash<Key>::value, "the Bloom filter needs std::hash<Key>");
+    bloomStats_ = BloomFilterStats();
+    bloom_.clear();
+    bloomBitsPerKey_ = bitsPerKey;
+    bloomRebuildAfter_ = rebuildAfterRemoves;
+    if(bitsPerKey == 0) return;
+
+    // k = bits per key * ln 2 minimizes the false-positive rate
+    bloomStats_.hashes = std::max(1, std::min(16, (int)(bitsPerKey * 0.693 + 0.5)));
+    rebuildBloom();
+    bloomStats_.rebuilds = 0;
+}
+
+template<typename Key, typename Value>
+BloomFilterStats BinarySearchTree<Key, Value>::bloomFilterStats() const
+{
+    return bloomStats_;
+}
+
+/**
+* The filter goes first, since a key it turns away costs no node access at all; the
+* cache only ever holds keys that are present.
+*/
+template<typename Key, typename Value>
+Node<Key, Value>* BinarySearchTree<Key, Value>::lookupNode(const Key& key) const
+{
+    if(bloom_.empty() && cache_.empty()) return internalFind(key);
+
+    Node<Key, Value>* n;
+    if(!screenLookup(key, n)) return NULL;
+    if(n != NULL) return n;
+    return finishLookup(key, internalFind(key));
 }
 
 template<typename Key, typename Value>
-bool BinarySearchTree<Key, Value>::balanced(const Node<Key, Value>* n)
+bool BinarySearchTree<Key, Value>::screenLookup(const Key& key, Node<Key, Value>*& n) const
 {
-	if(height(n)==0 || height(n)==1) return true;
-	if(height(n->getLeft())==0) return (height(n->getRight())<=1);
-	if(height(n->getRight())==0) return (height(n->getLeft())<=1);
-	// std::cout << "Node\t" << n->getKey() << std::endl;
-	// std::cout << "(LC, height)\t" << n->getLeft()->getKey() << " " << height(n->getLeft()) << std::endl;
-	// std::cout << "(RC, height)\t" << n->getRight()->getKey() << " " << height(n->getRight()) << std::endl;
-	if(abs(height(n->getLeft())-height(n->getRight()))>1) return false;
-	return balanced(n->getLeft()) && balanced(n->getRight());
+    n = NULL;
+    if(!bloom_.empty())
+    {
+        if((bloomRebuildAfter_ != 0 && bloomRemoves_ >= bloomRebuildAfter_) || bloomKeys_ > bloomCapacity_)
+            rebuildBloom();
+        if(!bloomTest(key, false))
+        {
+            ++bloomStats_.rejected;
+            return false;
+        }
+        ++bloomStats_.passed;
+    }
+
+    if(!cache_.empty())
+    {
+        Node<Key, Value>* cached = cache_[cacheSlot(key)];
+        if(cached != NULL)
+        {
+            BST_STATS_VISIT();
+            BST_STATS_COMPARE(1);
+            if(cached->getKey() == key)
+            {
+                ++cacheStats_.hits;
+                n = cached;
+                return true;
+            }
+        }
+        ++cacheStats_.misses;
+    }
+    return true;
 }
 
+/**
+* The node is filed under its own key, which is where forgetNode() looks: the byte hash
+* may put an equal key in another slot.
+*/
 template<typename Key, typename Value>
-int BinarySearchTree<Key, Value>::height(const Node<Key, Value>* n) 
+Node<Key, Value>* BinarySearchTree<Key, Value>::finishLookup(const Key& key, Node<Key, Value>* n) const
 {
-	if(n==NULL) return 0;
+    if(n != NULL && !cache_.empty()) cache_[cacheSlot(n->getKey())] = n;
+    if(n == NULL && !bloom_.empty()) ++bloomStats_.falsePositives;
+    return n;
+}
 
-	int l = height(n->getLeft())+1;
-	int r = height(n ->getRight())+1;
-	if(l>r) return l;
-	return r;
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::rememberKey(const Key& key)
+{
+    if(bloom_.empty()) return;
+    bloomTest(key, true);
+    ++bloomKeys_;
+}
+
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::forgetNode(Node<Key, Value>* n)
+{
+    if(!bloom_.empty()) ++bloomRemoves_;
+    if(cache_.empty()) return;
+    Node<Key, Value>*& slot = cache_[cacheSlot(n->getKey())];
+    if(slot == n)
+    {
+        slot = NULL;
+        ++cacheStats_.invalidations;
+    }
+}
+
+/**
+* Fibonacci hashing spreads keys whose std::hash is the identity, such as sequential
+* ints, over the whole table.
+*/
+template<typename Key, typename Value>
+size_t BinarySearchTree<Key, Value>::cacheSlot(const Key& key) const
+{
+    return (size_t)(((uint64_t)LookupCacheHash<Key>()(key) * 0x9E3779B97F4A7C15ull) >> cacheShift_);
+}
+
+/**
+* The bit positions come from one hash by double hashing, after a splitmix64 finalizer
+* so identity hashes such as ints' are spread, and are scaled onto the array with a
+* multiply instead of a modulo.
+*/
+template<typename Key, typename Value>
+bool BinarySearchTree<Key, Value>::bloomTest(const Key& key, bool set) const
+{
+    uint64_t h = (uint64_t)LookupCacheHash<Key>()(key);
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+    h ^= h >> 31;
+    uint32_t a = (uint32_t)h;
+    uint32_t b = (uint32_t)(h >> 32) | 1;
+
+    for(int i = 0; i < bloomStats_.hashes; i++)
+    {
+        uint64_t bit = ((uint64_t)(uint32_t)(a + i * b) * bloomStats_.bits) >> 32;
+        uint64_t mask = (uint64_t)1 << (bit & 63);
+        if(set) bloom_[bit >> 6] |= mask;
+        else if((bloom_[bit >> 6] & mask) == 0) return false;
+    }
+    return true;
+}
+
+/**
+* Sizes the array for twice the keys the tree holds (at least 1024), so growth alone
+* triggers the next rebuild only once the tree has doubled, then re-adds every key.
+*/
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::rebuildBloom() const
+{
+    size_t keys = 0;
+    for(Node<Key, Value>* n = root_; n != NULL; n = nextPreorder(n)) ++keys;
+
+    bloomCapacity_ = std::max<size_t>(1024, 2 * keys);
+    // the scaling in bloomTest() needs fewer than 2^32 bits
+    bloomStats_.bits = std::min<size_t>(bloomCapacity_ * bloomBitsPerKey_, (size_t)0xFFFFFFC0u);
+    bloom_.assign((bloomStats_.bits + 63) / 64, 0);
+    for(Node<Key, Value>* n = root_; n != NULL; n = nextPreorder(n)) bloomTest(n->getKey(), true);
+    bloomKeys_ = keys;
+    bloomRemoves_ = 0;
+    ++bloomStats_.rebuilds;
+}
+
+template<typename Key, typename Value>
+Node<Key, Value>* BinarySearchTree<Key, Value>::nextPreorder(Node<Key, Value>* n)
+{
+    if(n->getLeft() != NULL) return n->getLeft();
+    if(n->getRight() != NULL) return n->getRight();
+    while(n->getParent() != NULL)
+    {
+        Node<Key, Value>* parent = n->getParent();
+        if(parent->getLeft() == n && parent->getRight() != NULL) return parent->getRight();
+        n = parent;
+    }
+    return NULL;
 }
 
 
@@ -897,6 +1364,7 @@ void BinarySearchTree<Key, Value>::nodeSwap( Node<Key,Value>* n1, Node<Key,Value
     if((n1 == n2) || (n1 == NULL) || (n2 == NULL) ) {
         return;
     }
+    BST_STATS_COUNT(nodeSwaps);
     Node<Key, Value>* n1p = n1->getParent();
     Node<Key, Value>* n1r = n1->getRight();
     Node<Key, Value>* n1lt = n1->getLeft();
@@ -984,10 +1452,13 @@ void BinarySearchTree<Key, Value>::nodeSwap( Node<Key,Value>* n1, Node<Key,Value
    It will print up to 5 levels of the tree rooted at the passed node,
    in ASCII graphics format.
    We hope it will make debugging easier!
+   For bigger trees, exportDot() and exportJsonLines() write out every level.
   */
 
 // include print function (in its own file because it's fairly long)
 #include "print_bst.h"
+#include "export_bst.h"
+#include "parallel_bst.h"
 
 /*
 ---------------------------------------------------
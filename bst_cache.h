@@ -0,0 +1,101 @@
+#ifndef BST_CACHE_H
+#define BST_CACHE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+// Counters for BinarySearchTree's lookup cache (see setLookupCache()). Unlike TreeStats
+// they are per tree and always compiled in; turning the cache on or resizing it zeroes
+// them.
+struct LookupCacheStats
+{
+    LookupCacheStats() :
+        slots(0), hits(0), misses(0), invalidations(0)
+    {
+
+    }
+
+    size_t slots;
+    // lookups answered from the cache, and lookups that had to search the tree
+    uint64_t hits;
+    uint64_t misses;
+    // entries dropped because their node was deleted or the tree cleared
+    uint64_t invalidations;
+};
+
+// Shape and counters of BinarySearchTree's Bloom filter (see setBloomFilter()), per
+// tree like LookupCacheStats.
+struct BloomFilterStats
+{
+    BloomFilterStats() :
+        bits(0), hashes(0), rejected(0), passed(0), falsePositives(0), rebuilds(0)
+    {
+
+    }
+
+    // size of the bit array (bits / 8 bytes of memory) and bits set per key
+    size_t bits;
+    int hashes;
+    // lookups the filter answered "absent", and lookups it let through to the tree
+    uint64_t rejected;
+    uint64_t passed;
+    // lookups it let through for keys the tree turned out not to hold; the measured
+    // false-positive rate is falsePositives / (rejected + falsePositives)
+    uint64_t falsePositives;
+    uint64_t rebuilds;
+};
+
+template<typename T>
+struct LookupCacheVoid
+{
+    typedef void type;
+};
+
+// Hashes a key for the lookup cache and the Bloom filter: std::hash where Key has one,
+// otherwise the key's bytes. Equal keys need not have equal bytes (padding, or a
+// pointer inside the key), so the fallback can hash them apart. The cache files each
+// node under its own key's hash and confirms hits by comparing keys, so there that
+// only costs hits; a Bloom filter would answer "absent" for a present key, so
+// setBloomFilter() requires std::hash (see LookupCacheHasStdHash).
+template<typename Key, typename Enable = void>
+struct LookupCacheHash
+{
+    size_t operator()(const Key& key) const
+    {
+        // FNV-1a
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&key);
+        uint64_t h = 14695981039346656037ull;
+        for(size_t i = 0; i < sizeof(Key); i++)
+        {
+            h ^= bytes[i];
+            h *= 1099511628211ull;
+        }
+        return (size_t)h;
+    }
+};
+
+template<typename Key>
+struct LookupCacheHash<Key, typename LookupCacheVoid<decltype(std::hash<Key>()(std::declval<const Key&>()))>::type>
+{
+    size_t operator()(const Key& key) const
+    {
+        return std::hash<Key>()(key);
+    }
+};
+
+// Whether LookupCacheHash<Key> is std::hash, which hashes equal keys alike.
+template<typename Key, typename Enable = void>
+struct LookupCacheHasStdHash
+{
+    static const bool value = false;
+};
+
+template<typename Key>
+struct LookupCacheHasStdHash<Key, typename LookupCacheVoid<decltype(std::hash<Key>()(std::declval<const Key&>()))>::type>
+{
+    static const bool value = true;
+};
+
+#endif
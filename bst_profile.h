@@ -0,0 +1,34 @@
+#ifndef BST_PROFILE_H
+#define BST_PROFILE_H
+
+#include <map>
+#include <vector>
+#include <cstdint>
+
+// Shape of a tree, as measured by BinarySearchTree::profile(). Depths count the root
+// as 1, and a node's balance factor is its right subtree's height minus its left's.
+struct TreeProfile
+{
+    TreeProfile() :
+        height(0), size(0), leaves(0), averageLeafDepth(0.0), maxLeafDepth(0),
+        balanced(true), equalPaths(true)
+    {
+
+    }
+
+    int height;
+    uint64_t size;
+    uint64_t leaves;
+    double averageLeafDepth;
+    int maxLeafDepth;
+    // leafDepths[d] is the number of leaves at depth d
+    std::vector<uint64_t> leafDepths;
+    // balance factor -> number of nodes with it
+    std::map<int, uint64_t> balances;
+    // every node's subtrees differ in height by at most one
+    bool balanced;
+    // every leaf is at the same depth
+    bool equalPaths;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef BST_STATS_H
+#define BST_STATS_H
+
+#include <cstdint>
+#include <cstring>
+
+// Operation counters for BinarySearchTree and its subclasses.
+//
+// Counting is compiled in only when BST_STATS is defined (e.g. DEFS=-DBST_STATS in the
+// Makefile); otherwise every BST_* macro below expands to nothing and the trees carry no
+// extra code or data. Counters are thread_local, so concurrent readers of different
+// trees never write to a shared cache line. They are therefore per thread, not per tree.
+
+// The public operation a counted node visit is attributed to.
+enum TreeOp
+{
+    TREE_OP_NONE = 0,
+    TREE_OP_FIND,
+    TREE_OP_INSERT,
+    TREE_OP_REMOVE,
+    TREE_OP_COUNT
+};
+
+struct TreeStats
+{
+    TreeStats()
+    {
+        std::memset(this, 0, sizeof(*this));
+    }
+
+    // number of find/insert/remove calls, and nodes visited on behalf of each
+    uint64_t ops[TREE_OP_COUNT];
+    uint64_t visits[TREE_OP_COUNT];
+    uint64_t comparisons;
+    uint64_t singleRotations;
+    uint64_t doubleRotations;
+    uint64_t nodeSwaps;
+    // deepest node (root = 1) any operation has reached
+    int maxDepth;
+    // height of the tree when the snapshot was taken; not a counter
+    int height;
+};
+
+// The calling thread's counters.
+inline TreeStats& bstThreadStats()
+{
+    static thread_local TreeStats stats;
+    return stats;
+}
+
+// The operation currently being counted on this thread. Only the outermost public call
+// sets it, so e.g. the internalFind() inside insert() counts as part of the insert.
+inline TreeOp& bstThreadOp()
+{
+    static thread_local TreeOp op = TREE_OP_NONE;
+    return op;
+}
+
+class TreeOpScope
+{
+public:
+    explicit TreeOpScope(TreeOp op) : outer_(bstThreadOp() == TREE_OP_NONE)
+    {
+        if(outer_)
+        {
+            bstThreadOp() = op;
+            ++bstThreadStats().ops[op];
+        }
+    }
+
+    ~TreeOpScope()
+    {
+        if(outer_) bstThreadOp() = TREE_OP_NONE;
+    }
+
+private:
+    bool outer_;
+};
+
+#ifdef BST_STATS
+#define BST_STATS_OP(op) TreeOpScope bstStatsScope_(op)
+#define BST_STATS_VISIT() (++bstThreadStats().visits[bstThreadOp()])
+#define BST_STATS_COMPARE(n) (bstThreadStats().comparisons += (n))
+#define BST_STATS_DEPTH(d) do { if((d) > bstThreadStats().maxDepth) bstThreadStats().maxDepth = (d); } while(0)
+#define BST_STATS_COUNT(field) (++bstThreadStats().field)
+#else
+#define BST_STATS_OP(op) do { } while(0)
+#define BST_STATS_VISIT() do { } while(0)
+#define BST_STATS_COMPARE(n) do { } while(0)
+#define BST_STATS_DEPTH(d) ((void)(d))
+#define BST_STATS_COUNT(field) do { } while(0)
+#endif
+
+#endif
@@ -0,0 +1,312 @@
+#ifndef BST_TRACE_H
+#define BST_TRACE_H
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <type_traits>
+#include <cstring>
+#include <cstdio>
+#include <cstdint>
+
+// Operation traces for BinarySearchTree and its subclasses.
+//
+// Attach a TraceWriter to a tree with setTrace() and every insert, remove, find (and
+// operator[]), begin and iterator increment on that tree is appended to a binary trace
+// file. Records go through a 64KB buffer, and runs of increments collapse into a single
+// record, so tracing a full scan costs a counter bump per step. trace-replay runs a
+// trace against any tree implementation.
+//
+// File layout (host byte order): a TraceHeader, then one record per operation. A record
+// is one TraceOp byte followed by the raw key bytes for insert/remove/find, nothing for
+// begin, or an LEB128 step count for next. Keys must be trivially copyable.
+
+enum TraceOp
+{
+    TRACE_INSERT = 1,
+    TRACE_REMOVE,
+    TRACE_FIND,
+    // replay restarts its iterator at begin(); find also repositions it
+    TRACE_BEGIN,
+    // advance the iterator from the last begin/find by the record's count
+    TRACE_NEXT
+};
+
+// how replay should interpret the key bytes
+enum TraceKeyKind
+{
+    TRACE_KEY_OTHER = 0,
+    TRACE_KEY_SIGNED,
+    TRACE_KEY_UNSIGNED
+};
+
+struct TraceHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t keySize;
+    uint32_t keyKind;
+    uint32_t reserved;
+};
+
+#define BST_TRACE_MAGIC "BSTTRACE"
+#define BST_TRACE_VERSION 1
+
+/**
+* Reads only the header of a trace file, so a tool can pick the key type before
+* opening it with a TraceReader.
+*/
+inline TraceHeader readTraceHeader(const std::string& path)
+{
+    TraceHeader header;
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if(file == NULL) throw std::runtime_error("cannot open trace " + path);
+    size_t got = std::fread(&header, sizeof(header), 1, file);
+    std::fclose(file);
+    if(got != 1 || std::memcmp(header.magic, BST_TRACE_MAGIC, sizeof(header.magic)) != 0)
+        throw std::runtime_error(path + " is not a tree trace");
+    if(header.version != BST_TRACE_VERSION)
+        throw std::runtime_error(path + " has an unsupported trace version");
+    return header;
+}
+
+/**
+* Appends operation records to a trace file. Not thread-safe: use one writer per tree.
+*/
+template <typename Key>
+class TraceWriter
+{
+public:
+    explicit TraceWriter(const std::string& path);
+    ~TraceWriter();
+
+    void record(TraceOp op, const Key& key);
+    void recordBegin();
+    void recordNext();
+    // writes out buffered records; the destructor does this too
+    void flush();
+    uint64_t records() const;
+
+private:
+    TraceWriter(const TraceWriter&);
+    TraceWriter& operator=(const TraceWriter&);
+
+    void put(const void* data, size_t len);
+    void flushNext();
+    void writeBuffer();
+
+    FILE* file_;
+    std::vector<char> buffer_;
+    size_t used_;
+    uint64_t pendingNext_;
+    uint64_t records_;
+};
+
+/**
+* Reads back the records of a trace file written by a TraceWriter<Key>.
+*/
+template <typename Key>
+class TraceReader
+{
+public:
+    explicit TraceReader(const std::string& path);
+    ~TraceReader();
+
+    // Reads the next record. key is set for insert/remove/find and count for next.
+    // Returns false at the end of the trace.
+    bool next(TraceOp& op, Key& key, uint64_t& count);
+
+private:
+    TraceReader(const TraceReader&);
+    TraceReader& operator=(const TraceReader&);
+
+    FILE* file_;
+};
+
+/*
+  -----------------------------------------------
+  Begin implementations for the TraceWriter class.
+  -----------------------------------------------
+*/
+
+template<typename Key>
+TraceWriter<Key>::TraceWriter(const std::string& path) :
+    file_(std::fopen(path.c_str(), "wb")), buffer_(1 << 16), used_(0), pendingNext_(0), records_(0)
+{
+    static_assert(std::is_trivially_copyable<Key>::value, "traced keys must be trivially copyable");
+    if(file_ == NULL) throw std::runtime_error("cannot create trace " + path);
+
+    TraceHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, BST_TRACE_MAGIC, sizeof(header.magic));
+    header.version = BST_TRACE_VERSION;
+    header.keySize = sizeof(Key);
+    header.keyKind = !std::is_integral<Key>::value ? TRACE_KEY_OTHER :
+        std::is_signed<Key>::value ? TRACE_KEY_SIGNED : TRACE_KEY_UNSIGNED;
+    put(&header, sizeof(header));
+}
+
+/**
+* Flushes the trace. Errors here cannot be reported, so call flush() first if they matter.
+*/
+template<typename Key>
+TraceWriter<Key>::~TraceWriter()
+{
+    try
+    {
+        flush();
+    }
+    catch(const std::runtime_error&)
+    {
+
+    }
+    std::fclose(file_);
+}
+
+template<typename Key>
+void TraceWriter<Key>::record(TraceOp op, const Key& key)
+{
+    flushNext();
+    char rec[1 + sizeof(Key)];
+    rec[0] = (char)op;
+    std::memcpy(rec + 1, &key, sizeof(Key));
+    put(rec, sizeof(rec));
+    ++records_;
+}
+
+template<typename Key>
+void TraceWriter<Key>::recordBegin()
+{
+    flushNext();
+    char op = (char)TRACE_BEGIN;
+    put(&op, 1);
+    ++records_;
+}
+
+template<typename Key>
+void TraceWriter<Key>::recordNext()
+{
+    ++pendingNext_;
+}
+
+template<typename Key>
+void TraceWriter<Key>::flush()
+{
+    flushNext();
+    writeBuffer();
+    if(std::fflush(file_) != 0) throw std::runtime_error("cannot write trace");
+}
+
+template<typename Key>
+uint64_t TraceWriter<Key>::records() const
+{
+    return records_ + (pendingNext_ > 0 ? 1 : 0);
+}
+
+template<typename Key>
+void TraceWriter<Key>::put(const void* data, size_t len)
+{
+    if(used_ + len > buffer_.size()) writeBuffer();
+    std::memcpy(&buffer_[used_], data, len);
+    used_ += len;
+}
+
+/**
+* Turns the increments counted since the last record into one TRACE_NEXT record.
+*/
+template<typename Key>
+void TraceWriter<Key>::flushNext()
+{
+    if(pendingNext_ == 0) return;
+    char rec[11];
+    size_t len = 0;
+    rec[len++] = (char)TRACE_NEXT;
+    uint64_t n = pendingNext_;
+    do
+    {
+        rec[len++] = (char)((n & 0x7f) | (n > 0x7f ? 0x80 : 0));
+        n >>= 7;
+    } while(n != 0);
+    pendingNext_ = 0;
+    put(rec, len);
+    ++records_;
+}
+
+template<typename Key>
+void TraceWriter<Key>::writeBuffer()
+{
+    if(used_ > 0 && std::fwrite(&buffer_[0], 1, used_, file_) != used_)
+        throw std::runtime_error("cannot write trace");
+    used_ = 0;
+}
+
+/*
+  -----------------------------------------------
+  End implementations for the TraceWriter class.
+  -----------------------------------------------
+*/
+
+/*
+  -----------------------------------------------
+  Begin implementations for the TraceReader class.
+  -----------------------------------------------
+*/
+
+template<typename Key>
+TraceReader<Key>::TraceReader(const std::string& path) :
+    file_(NULL)
+{
+    TraceHeader header = readTraceHeader(path);
+    if(header.keySize != sizeof(Key))
+        throw std::runtime_error(path + " was recorded with a different key type");
+    file_ = std::fopen(path.c_str(), "rb");
+    if(file_ == NULL || std::fseek(file_, sizeof(TraceHeader), SEEK_SET) != 0)
+        throw std::runtime_error("cannot open trace " + path);
+}
+
+template<typename Key>
+TraceReader<Key>::~TraceReader()
+{
+    if(file_ != NULL) std::fclose(file_);
+}
+
+/**
+* A record cut short by a crash ends the trace like a clean end of file does.
+*/
+template<typename Key>
+bool TraceReader<Key>::next(TraceOp& op, Key& key, uint64_t& count)
+{
+    int c = std::getc(file_);
+    if(c == EOF) return false;
+    op = (TraceOp)c;
+    count = 1;
+    switch(op)
+    {
+    case TRACE_INSERT:
+    case TRACE_REMOVE:
+    case TRACE_FIND:
+        return std::fread(&key, sizeof(Key), 1, file_) == 1;
+    case TRACE_BEGIN:
+        return true;
+    case TRACE_NEXT:
+        count = 0;
+        for(int shift = 0; shift < 64; shift += 7)
+        {
+            c = std::getc(file_);
+            if(c == EOF) return false;
+            count |= (uint64_t)(c & 0x7f) << shift;
+            if((c & 0x80) == 0) return true;
+        }
+        throw std::runtime_error("corrupt trace record");
+    default:
+        throw std::runtime_error("corrupt trace record");
+    }
+}
+
+/*
+  -----------------------------------------------
+  End implementations for the TraceReader class.
+  -----------------------------------------------
+*/
+
+#endif
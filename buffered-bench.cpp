@@ -0,0 +1,106 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
+#include "bench_utils.h"
+#include "avlbst.h"
+#include "buffered_avl.h"
+
+using namespace std;
+
+// BufferedAVLTree at several buffer sizes against the plain AVLTree: write throughput
+// in a burst, and what lookups pay for checking a half-full buffer first.
+//
+// usage: buffered-bench [entries] [writes]
+//
+// Each tree starts with the even keys below 2 * entries, inserted in random order.
+// The burst inserts new odd keys (70%) and removes loaded ones (30%) and ends with a
+// flush; the new keys are random in one run and ascending past the loaded ones, as
+// time-ordered writes are, in the other. The lookups then probe loaded keys while the buffer
+// holds half its threshold of writes to other keys.
+
+static const size_t THRESHOLDS[] = { 64, 256, 1024, 4096 };
+
+struct Result
+{
+	double writesPerSec;
+	double lookupsPerSec;
+};
+
+template<typename Key, typename Value>
+static void flushIfBuffered(AVLTree<Key, Value>&) { }
+
+template<typename Key, typename Value>
+static void flushIfBuffered(BufferedAVLTree<Key, Value>& tree) { tree.flush(); }
+
+template<typename Tree>
+static Result run(Tree& tree, size_t n, size_t writes, size_t pendingWrites, bool ascending)
+{
+	mt19937 rng(43);
+	vector<int> keys(n);
+	for(size_t i = 0; i < n; i++) keys[i] = (int)(2 * i);
+	shuffle(keys.begin(), keys.end(), rng);
+	for(size_t i = 0; i < n; i++) tree.insert(make_pair(keys[i], (int)i));
+	shuffle(keys.begin(), keys.end(), rng);
+
+	Stopwatch watch;
+	size_t removed = 0;
+	for(size_t i = 0; i < writes; i++)
+	{
+		int key = ascending ? (int)(2 * n + 2 * i + 1) : (int)(2 * (rng() % n) + 1);
+		if(rng() % 10 < 7) tree.insert(make_pair(key, (int)i));
+		else tree.remove(keys[removed++ % n]);
+	}
+	flushIfBuffered(tree);
+	double writeSecs = watch.seconds();
+
+	// writes to keys no probe asks for
+	for(size_t i = 0; i < pendingWrites; i++)
+		tree.insert(make_pair(-1 - (int)i, 0));
+
+	size_t lookups = 2000000;
+	watch.restart();
+	size_t hits = 0;
+	for(size_t i = 0; i < lookups; i++)
+		if(tree.find(keys[(removed + i) % n]) != tree.end()) hits++;
+	double lookupSecs = watch.seconds();
+	if(hits == 0) cerr << "no hits" << endl;
+
+	Result result = { writes / writeSecs, lookups / lookupSecs };
+	return result;
+}
+
+int main(int argc, char *argv[])
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+	size_t writes = argc > 2 ? strtoul(argv[2], NULL, 10) : 1000000;
+	if(n == 0)
+	{
+		cerr << "usage: " << argv[0] << " [entries > 0] [writes]" << endl;
+		return 1;
+	}
+
+	for(int ascending = 0; ascending < 2; ascending++)
+	{
+		cout << (ascending ? "ascending" : "random") << " new keys" << endl;
+		Result plain;
+		{
+			AVLTree<int, int> tree;
+			plain = run(tree, n, writes, 0, ascending);
+		}
+		cout << "  AVLTree<int,int>" << endl;
+		cout << "    writes/s:   " << (uint64_t)plain.writesPerSec << endl;
+		cout << "    lookups/s:  " << (uint64_t)plain.lookupsPerSec << endl;
+
+		for(size_t t = 0; t < sizeof(THRESHOLDS) / sizeof(THRESHOLDS[0]); t++)
+		{
+			BufferedAVLTree<int, int> tree(THRESHOLDS[t]);
+			Result buffered = run(tree, n, writes, THRESHOLDS[t] / 2, ascending);
+			cout << "  BufferedAVLTree<int,int>, threshold " << THRESHOLDS[t] << endl;
+			cout << "    writes/s:   " << (uint64_t)buffered.writesPerSec << " (" << buffered.writesPerSec / plain.writesPerSec << "x)" << endl;
+			cout << "    lookups/s:  " << (uint64_t)buffered.lookupsPerSec << " (" << buffered.lookupsPerSec / plain.lookupsPerSec << "x)" << endl;
+		}
+	}
+	return 0;
+}
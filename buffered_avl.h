@@ -0,0 +1,307 @@
+#ifndef BUFFERED_AVL_H
+#define BUFFERED_AVL_H
+
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include "avlbst.h"
+
+/**
+* An AVLTree with a write buffer in front of it, in the manner of an LSM tree's
+* memtable. insert() and remove() only append the operation to an array, a remove as a
+* tombstone, and point an index from the key to it. Once threshold operations are
+* waiting, flush() takes the last one per key from the index, sorts them by key and
+* applies the lot the way insertBatch()/eraseBatch() do, so the searches share paths
+* and a burst of writes costs one pass over the tree.
+*
+* When Key has std::hash the index is an open-addressed table sized once, at
+* construction, for threshold keys, so a buffered write allocates nothing and the
+* index answers in O(1) expected. Other keys are indexed by a std::map, which costs a
+* node allocation per newly buffered key and O(log threshold) per lookup.
+*
+* find() and operator[] ask the index before the tree: a tombstone answers "not
+* found" at once, and a key written since the last flush forces a flush so the result
+* can be a tree iterator. begin() and clear() flush or drop the
+* buffer first. Everything else (isBalanced(), profile(), the exporters, cursors, and
+* calls made through a BinarySearchTree or AVLTree reference) sees only flushed writes,
+* so call flush() before those. AVLTree's hinted insert is hidden by insert(), and its
+* batch and build calls made through an AVLTree reference skip the buffer, so a later
+* flush() could overwrite them with older writes. Value must be default-constructible.
+*/
+template <typename Key, typename Value>
+class BufferedAVLTree : public AVLTree<Key, Value>
+{
+public:
+    typedef typename AVLTree<Key, Value>::iterator iterator;
+
+    explicit BufferedAVLTree(size_t threshold = 256);
+
+    virtual void insert(const std::pair<const Key, Value>& keyValuePair) override;
+    virtual void remove(const Key& key) override;
+    // applied after the buffer, since they may overwrite what it holds
+    template<typename InputIt> void insertBatch(InputIt first, InputIt last);
+    template<typename InputIt> void eraseBatch(InputIt first, InputIt last);
+    template<typename InputIt> void buildParallel(InputIt first, InputIt last, unsigned threads = 0);
+
+    iterator find(const Key& key);
+    Value& operator[](const Key& key);
+    iterator begin();
+    virtual void clear() override;
+
+    // applies every buffered operation to the tree
+    void flush();
+    // operations waiting in the buffer
+    size_t pending() const;
+
+protected:
+    struct BufferedOp
+    {
+        Key key;
+        Value value;
+        bool tombstone;
+    };
+
+    // marks an empty slot of table_
+    static const size_t NO_OP = (size_t)-1;
+
+    // the newest buffered operation on key, or NULL
+    const BufferedOp* lastOp(const Key& key) const;
+    void push(const BufferedOp& op);
+    // key's slot in table_, or the empty slot where it would go
+    size_t tableSlot(const Key& key) const;
+    // forgets every buffered operation
+    void resetIndex();
+
+    std::vector<BufferedOp> buffer_;
+    // each buffered key's newest operation, as a position in buffer_: in table_, by
+    // linear probing from the top tableBits_ bits of the key's mixed hash, when Key has
+    // std::hash, and in index_ otherwise
+    std::vector<size_t> table_;
+    int tableBits_;
+    std::map<Key, size_t> index_;
+    size_t threshold_;
+};
+
+/*
+  -----------------------------------------------------
+  Begin implementations for the BufferedAVLTree class.
+  -----------------------------------------------------
+*/
+
+template<class Key, class Value>
+const size_t BufferedAVLTree<Key, Value>::NO_OP;
+
+template<class Key, class Value>
+BufferedAVLTree<Key, Value>::BufferedAVLTree(size_t threshold) :
+    tableBits_(0), threshold_(threshold > 0 ? threshold : 1)
+{
+    buffer_.reserve(threshold_);
+    if(!LookupCacheHasStdHash<Key>::value) return;
+    // at most half full, so probe runs stay short
+    while(((size_t)1 << tableBits_) < 2 * threshold_) tableBits_++;
+    table_.assign((size_t)1 << tableBits_, NO_OP);
+}
+
+/**
+* Operations are traced when they are buffered, and counted by BST_STATS when a flush
+* applies them.
+*/
+template<class Key, class Value>
+void BufferedAVLTree<Key, Value>::insert(const std::pair<const Key, Value>& keyValuePair)
+{
+    if(this->trace_ != NULL) this->trace_->record(TRACE_INSERT, keyValuePair.first);
+    BufferedOp op = { keyValuePair.first, keyValuePair.second, false };
+    push(op);
+}
+
+template<class Key, class Value>
+void BufferedAVLTree<Key, Value>::remove(const Key& key)
+{
+    if(this->trace_ != NULL) this->trace_->record(TRACE_REMOVE, key);
+    BufferedOp op = { key, Value(), true };
+    push(op);
+}
+
+template<class Key, class Value>
+template<typename InputIt>
+void BufferedAVLTree<Key, Value>::insertBatch(InputIt first, InputIt last)
+{
+    flush();
+    AVLTree<Key, Value>::insertBatch(first, last);
+}
+
+template<class Key, class Value>
+template<typename InputIt>
+void BufferedAVLTree<Key, Value>::eraseBatch(InputIt first, InputIt last)
+{
+    flush();
+    AVLTree<Key, Value>::eraseBatch(first, last);
+}
+
+template<class Key, class Value>
+template<typename InputIt>
+void BufferedAVLTree<Key, Value>::buildParallel(InputIt first, InputIt last, unsigned threads)
+{
+    flush();
+    AVLTree<Key, Value>::buildParallel(first, last, threads);
+}
+
+template<class Key, class Value>
+typename BufferedAVLTree<Key, Value>::iterator BufferedAVLTree<Key, Value>::find(const Key& key)
+{
+    const BufferedOp* op = lastOp(key);
+    if(op != NULL && op->tombstone)
+    {
+        BST_STATS_OP(TREE_OP_FIND);
+        if(this->trace_ != NULL) this->trace_->record(TRACE_FIND, key);
+        return this->end();
+    }
+    if(op != NULL) flush();
+    return AVLTree<Key, Value>::find(key);
+}
+
+template<class Key, class Value>
+Value& BufferedAVLTree<Key, Value>::operator[](const Key& key)
+{
+    const BufferedOp* op = lastOp(key);
+    if(op != NULL && op->tombstone)
+    {
+        BST_STATS_OP(TREE_OP_FIND);
+        if(this->trace_ != NULL) this->trace_->record(TRACE_FIND, key);
+        throw std::out_of_range("Invalid key");
+    }
+    if(op != NULL) flush();
+    return AVLTree<Key, Value>::operator[](key);
+}
+
+template<class Key, class Value>
+typename BufferedAVLTree<Key, Value>::iterator BufferedAVLTree<Key, Value>::begin()
+{
+    flush();
+    return AVLTree<Key, Value>::begin();
+}
+
+template<class Key, class Value>
+void BufferedAVLTree<Key, Value>::clear()
+{
+    resetIndex();
+    AVLTree<Key, Value>::clear();
+}
+
+/**
+* The operations were traced when they were buffered, so tracing is paused while they
+* are applied. The map hands the keys over in order; the table's are sorted.
+*/
+template<class Key, class Value>
+void BufferedAVLTree<Key, Value>::flush()
+{
+    if(buffer_.empty()) return;
+
+    // only the newest operation on each key counts
+    std::vector<std::pair<Key, Value> > upserts;
+    std::vector<Key> erases;
+    if(LookupCacheHasStdHash<Key>::value)
+    {
+        for(size_t i = 0; i < buffer_.size(); i++)
+        {
+            const BufferedOp& op = buffer_[i];
+            if(table_[tableSlot(op.key)] != i) continue;
+            if(op.tombstone) erases.push_back(op.key);
+            else upserts.push_back(std::make_pair(op.key, op.value));
+        }
+        std::sort(upserts.begin(), upserts.end(), typename AVLTree<Key, Value>::BatchKeyLess());
+        std::sort(erases.begin(), erases.end());
+    }
+    else
+    {
+        for(typename std::map<Key, size_t>::const_iterator it = index_.begin(); it != index_.end(); ++it)
+        {
+            const BufferedOp& op = buffer_[it->second];
+            if(op.tombstone) erases.push_back(op.key);
+            else upserts.push_back(std::make_pair(op.key, op.value));
+        }
+    }
+    resetIndex();
+
+    TraceWriter<Key>* trace = this->trace_;
+    this->trace_ = NULL;
+    this->eraseSorted(erases);
+    this->insertSorted(upserts);
+    this->trace_ = trace;
+}
+
+template<class Key, class Value>
+size_t BufferedAVLTree<Key, Value>::pending() const
+{
+    return buffer_.size();
+}
+
+template<class Key, class Value>
+const typename BufferedAVLTree<Key, Value>::BufferedOp* BufferedAVLTree<Key, Value>::lastOp(const Key& key) const
+{
+    if(LookupCacheHasStdHash<Key>::value)
+    {
+        if(buffer_.empty()) return NULL;
+        size_t at = table_[tableSlot(key)];
+        return at == NO_OP ? NULL : &buffer_[at];
+    }
+    typename std::map<Key, size_t>::const_iterator it = index_.find(key);
+    if(it == index_.end()) return NULL;
+    return &buffer_[it->second];
+}
+
+template<class Key, class Value>
+void BufferedAVLTree<Key, Value>::push(const BufferedOp& op)
+{
+    if(LookupCacheHasStdHash<Key>::value) table_[tableSlot(op.key)] = buffer_.size();
+    else index_[op.key] = buffer_.size();
+    buffer_.push_back(op);
+    if(buffer_.size() >= threshold_) flush();
+}
+
+/**
+* Fibonacci hashing, as in the lookup cache. The table holds at most threshold keys in
+* twice as many slots, so a probe always reaches an empty slot.
+*/
+template<class Key, class Value>
+size_t BufferedAVLTree<Key, Value>::tableSlot(const Key& key) const
+{
+    size_t mask = table_.size() - 1;
+    size_t i = (size_t)(((uint64_t)LookupCacheHash<Key>()(key) * 0x9E3779B97F4A7C15ull) >> (64 - tableBits_));
+    for(; table_[i] != NO_OP; i = (i + 1) & mask)
+    {
+        if(buffer_[table_[i]].key == key) break;
+    }
+    return i;
+}
+
+/**
+* Empties only the table slots in use, so a flush costs O(pending) rather than
+* O(threshold). They are all found before any is emptied, since an emptied slot would
+* cut the probe runs that pass through it.
+*/
+template<class Key, class Value>
+void BufferedAVLTree<Key, Value>::resetIndex()
+{
+    if(LookupCacheHasStdHash<Key>::value)
+    {
+        std::vector<size_t> used(buffer_.size());
+        for(size_t i = 0; i < buffer_.size(); i++) used[i] = tableSlot(buffer_[i].key);
+        for(size_t i = 0; i < used.size(); i++) table_[used[i]] = NO_OP;
+    }
+    buffer_.clear();
+    index_.clear();
+}
+
+/*
+  -----------------------------------------------------
+  End implementations for the BufferedAVLTree class.
+  -----------------------------------------------------
+*/
+
+#endif
@@ -0,0 +1,73 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <cstdlib>
+#include "bench_utils.h"
+#include "avlbst.h"
+
+using namespace std;
+
+// AVLTree::buildParallel() against loading the same dump with insert() or
+// insertBatch(), at several thread counts.
+//
+// usage: build-bench [entries]
+//
+// The dump holds entries pairs in random order, with about one key in ten repeated
+// so the last-wins deduplication has work to do. Every tree is checked against the
+// insert() one.
+
+static const unsigned THREADS[] = { 1, 2, 4, 8, 16 };
+
+typedef pair<int, int> Entry;
+
+static bool sameContents(const AVLTree<int, int>& a, const AVLTree<int, int>& b)
+{
+	AVLTree<int, int>::iterator x = a.begin(), y = b.begin();
+	for(; x != a.end() && y != b.end(); ++x, ++y)
+		if(x->first != y->first || x->second != y->second) return false;
+	return x == a.end() && y == b.end();
+}
+
+int main(int argc, char *argv[])
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 4000000;
+	if(n == 0)
+	{
+		cerr << "usage: " << argv[0] << " [entries > 0]" << endl;
+		return 1;
+	}
+
+	mt19937 rng(49);
+	vector<Entry> dump(n);
+	for(size_t i = 0; i < n; i++) dump[i] = Entry((int)(rng() % (n + n / 10)), (int)i);
+
+	cout << n << " pairs, " << thread::hardware_concurrency() << " hardware threads" << endl;
+
+	AVLTree<int, int> reference;
+	Stopwatch watch;
+	for(size_t i = 0; i < n; i++) reference.insert(dump[i]);
+	double insertSecs = watch.seconds();
+	cout << "  insert() loop:    " << (uint64_t)(n / insertSecs) << " pairs/s" << endl;
+
+	{
+		AVLTree<int, int> tree;
+		watch.restart();
+		tree.insertBatch(dump.begin(), dump.end());
+		double secs = watch.seconds();
+		if(!sameContents(tree, reference)) cerr << "insertBatch() mismatch" << endl;
+		cout << "  insertBatch():    " << (uint64_t)(n / secs) << " pairs/s (" << insertSecs / secs << "x)" << endl;
+	}
+
+	for(size_t t = 0; t < sizeof(THREADS) / sizeof(THREADS[0]); t++)
+	{
+		AVLTree<int, int> tree;
+		watch.restart();
+		tree.buildParallel(dump.begin(), dump.end(), THREADS[t]);
+		double secs = watch.seconds();
+		if(!sameContents(tree, reference)) cerr << "buildParallel() mismatch at " << THREADS[t] << " threads" << endl;
+		cout << "  buildParallel(), " << THREADS[t] << " threads: " << (uint64_t)(n / secs) << " pairs/s (" << insertSecs / secs << "x)" << endl;
+	}
+	return 0;
+}
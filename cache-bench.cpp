@@ -0,0 +1,76 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
+#include "bench_utils.h"
+#include "avlbst.h"
+
+using namespace std;
+
+// AVLTree::find() with the lookup cache off and at several sizes, on a skewed workload.
+//
+// usage: cache-bench [entries] [hot keys]
+//
+// 90% of the lookups go to a fixed random set of hot keys and the rest to any key.
+// One lookup in a hundred is followed by removing and re-inserting a hot key, so
+// entries are invalidated as they would be by writes.
+
+static const size_t SLOTS[] = { 0, 1024, 4096, 16384, 65536 };
+static const size_t LOOKUPS = 4000000;
+
+static void run(AVLTree<int, int>& tree, size_t n, const vector<int>& hot, size_t slots)
+{
+	tree.setLookupCache(slots);
+	mt19937 rng(46);
+	size_t hits = 0;
+	Stopwatch watch;
+	for(size_t i = 0; i < LOOKUPS; i++)
+	{
+		int key = rng() % 10 < 9 ? hot[rng() % hot.size()] : (int)(rng() % n);
+		if(tree.find(key) != tree.end()) hits++;
+		if(i % 100 == 0)
+		{
+			int victim = hot[rng() % hot.size()];
+			tree.remove(victim);
+			tree.insert(make_pair(victim, (int)i));
+		}
+	}
+	double secs = watch.seconds();
+	if(hits != LOOKUPS) cerr << "lost keys" << endl;
+
+	LookupCacheStats stats = tree.lookupCacheStats();
+	if(slots == 0) cout << "  no cache" << endl;
+	else cout << "  cache slots " << stats.slots << endl;
+	cout << "    lookups/s:      " << (uint64_t)(LOOKUPS / secs) << endl;
+	if(slots != 0)
+	{
+		cout << "    hit rate:       " << (double)stats.hits / (stats.hits + stats.misses) << endl;
+		cout << "    invalidations:  " << stats.invalidations << endl;
+		cout << "    cache bytes:    " << stats.slots * sizeof(Node<int, int>*) << endl;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 4000000;
+	size_t hotKeys = argc > 2 ? strtoul(argv[2], NULL, 10) : 4096;
+	if(n == 0 || hotKeys == 0 || hotKeys > n)
+	{
+		cerr << "usage: " << argv[0] << " [entries > 0] [hot keys <= entries]" << endl;
+		return 1;
+	}
+
+	mt19937 rng(46);
+	vector<int> keys(n);
+	for(size_t i = 0; i < n; i++) keys[i] = (int)i;
+	shuffle(keys.begin(), keys.end(), rng);
+	AVLTree<int, int> tree;
+	for(size_t i = 0; i < n; i++) tree.insert(make_pair(keys[i], (int)i));
+	vector<int> hot(keys.begin(), keys.begin() + hotKeys);
+
+	cout << "AVLTree<int,int> with " << n << " entries, " << hotKeys << " hot keys" << endl;
+	for(size_t s = 0; s < sizeof(SLOTS) / sizeof(SLOTS[0]); s++)
+		run(tree, n, hot, SLOTS[s]);
+	return 0;
+}
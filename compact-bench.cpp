@@ -0,0 +1,64 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
+#include "bench_utils.h"
+#include "bst.h"
+#include "avlbst.h"
+#include "compact_avl.h"
+
+using namespace std;
+
+// Memory per entry and lookup throughput of CompactAVLTree against AVLTree.
+//
+// usage: compact-bench [entries] [lookups]
+
+template<typename Tree>
+static void run(const char* name, const vector<int>& keys, const vector<int>& probes)
+{
+	size_t before = residentBytes();
+	Tree* tree = new Tree;
+	for(size_t i = 0; i < keys.size(); i++)
+		tree->insert(make_pair(keys[i], (char)i));
+	size_t after = residentBytes();
+
+	Stopwatch watch;
+	size_t hits = 0;
+	for(size_t i = 0; i < probes.size(); i++)
+		if(tree->find(probes[i]) != tree->end()) hits++;
+	double secs = watch.seconds();
+
+	watch.restart();
+	long sum = 0;
+	for(typename Tree::iterator it = tree->begin(); it != tree->end(); ++it)
+		sum += it->first;
+	double scanSecs = watch.seconds();
+
+	cout << name << endl;
+	cout << "  bytes per entry (RSS): " << (double)(after - before) / keys.size() << endl;
+	cout << "  lookups/s:             " << (uint64_t)(probes.size() / secs) << " (" << hits << " hits)" << endl;
+	cout << "  scan entries/s:        " << (uint64_t)(keys.size() / scanSecs) << " (checksum " << sum << ")" << endl;
+	delete tree;
+}
+
+int main(int argc, char *argv[])
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+	size_t lookups = argc > 2 ? strtoul(argv[2], NULL, 10) : 5000000;
+
+	mt19937 rng(104);
+	vector<int> keys(n);
+	for(size_t i = 0; i < n; i++) keys[i] = (int)i;
+	shuffle(keys.begin(), keys.end(), rng);
+
+	uniform_int_distribution<int> dist(0, (int)(2 * n));
+	vector<int> probes(lookups);
+	for(size_t i = 0; i < lookups; i++) probes[i] = dist(rng);
+
+	cout << "sizeof(AVLNode<int,char>) = " << sizeof(AVLNode<int, char>)
+		<< ", sizeof(CompactNode<int,char>) = " << sizeof(CompactNode<int, char>) << endl;
+	run<CompactAVLTree<int, char> >("CompactAVLTree<int,char>", keys, probes);
+	run<AVLTree<int, char> >("AVLTree<int,char>", keys, probes);
+	return 0;
+}
@@ -0,0 +1,633 @@
+#ifndef COMPACT_AVL_H
+#define COMPACT_AVL_H
+
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <new>
+
+/**
+* A node of a CompactAVLTree. Nodes live in one contiguous pool and refer to each
+* other by 32-bit pool index instead of by pointer. There is no vtable, and the
+* balance factor is packed into the top two bits of the parent link, so for an
+* <int, char> tree a node is 20 bytes instead of the 48 of an AVLNode.
+*
+* Because two bits of the parent link are taken by the balance, a tree holds at
+* most 2^30 - 1 nodes.
+*/
+template <typename Key, typename Value>
+struct CompactNode
+{
+    static const uint32_t NIL = (1u << 30) - 1;
+
+    CompactNode(const Key& key, const Value& value, uint32_t parent) :
+        item(key, value), left(NIL), right(NIL), parentBalance(parent | (1u << 30))
+    {
+
+    }
+
+    uint32_t parent() const { return parentBalance & NIL; }
+    void setParent(uint32_t p) { parentBalance = (parentBalance & ~NIL) | p; }
+    // stored as balance + 1 so that -1, 0 and +1 fit in two bits
+    int balance() const { return (int)(parentBalance >> 30) - 1; }
+    void setBalance(int b) { parentBalance = (parentBalance & NIL) | ((uint32_t)(b + 1) << 30); }
+
+    std::pair<const Key, Value> item;
+    uint32_t left;
+    uint32_t right;
+    uint32_t parentBalance;
+};
+
+/**
+* An AVL tree with the same interface as BinarySearchTree, but whose nodes are kept in
+* a contiguous pool linked by 32-bit indices. Walking the tree touches far fewer cache
+* lines than chasing 8-byte pointers through individually allocated nodes.
+*
+* A node keeps its slot for as long as it is in the tree: remove() relinks nodes rather
+* than moving items between slots, and puts the freed slot on a free list that insert()
+* takes from before growing the pool. Iterators therefore stay valid until their own
+* entry is removed. A freed slot keeps its old item until it is reused.
+*/
+template <typename Key, typename Value>
+class CompactAVLTree
+{
+public:
+    typedef CompactNode<Key, Value> NodeType;
+    typedef std::pair<const Key, Value> ItemType;
+    static const uint32_t NIL = NodeType::NIL;
+
+    CompactAVLTree();
+    virtual ~CompactAVLTree();
+    virtual void insert(const std::pair<const Key, Value>& keyValuePair);
+    virtual void remove(const Key& key);
+    void clear();
+    bool isBalanced() const;
+    void print() const;
+    bool empty() const;
+
+    size_t size() const;
+    // Pre-sizes the node pool for n entries.
+    void reserve(size_t n);
+    // Bytes currently held by the node pool.
+    size_t memoryUsage() const;
+
+    class iterator
+    {
+    public:
+        iterator();
+
+        std::pair<const Key,Value>& operator*() const;
+        std::pair<const Key,Value>* operator->() const;
+
+        bool operator==(const iterator& rhs) const;
+        bool operator!=(const iterator& rhs) const;
+
+        iterator& operator++();
+
+    protected:
+        friend class CompactAVLTree<Key, Value>;
+        iterator(CompactAVLTree<Key, Value>* tree, uint32_t index);
+        CompactAVLTree<Key, Value>* tree_;
+        uint32_t current_;
+    };
+
+    iterator begin() const;
+    iterator end() const;
+    iterator find(const Key& key) const;
+    Value& operator[](const Key& key);
+    Value const & operator[](const Key& key) const;
+
+protected:
+    uint32_t internalFind(const Key& key) const;
+    uint32_t getSmallestNode() const;
+    uint32_t successor(uint32_t current) const;
+    int height(uint32_t n) const;
+
+    void replaceChild(uint32_t parent, uint32_t oldChild, uint32_t newChild);
+    uint32_t rotateLeft(uint32_t x);
+    uint32_t rotateRight(uint32_t x);
+    uint32_t rebalance(uint32_t x, int bx);
+    // puts a new node in a free slot, or at the end of the pool
+    uint32_t acquireNode(const Key& key, const Value& value, uint32_t parent);
+    void releaseNode(uint32_t n);
+    // swaps the tree positions of n, which has two children, and its predecessor
+    void swapWithPredecessor(uint32_t n, uint32_t pred);
+
+    std::vector<NodeType> pool_;
+    uint32_t root_;
+    // the free slots, linked through their left fields
+    uint32_t free_;
+    size_t freeCount_;
+};
+
+/*
+--------------------------------------------------------------
+Begin implementations for the CompactAVLTree::iterator class.
+---------------------------------------------------------------
+*/
+
+template<class Key, class Value>
+CompactAVLTree<Key, Value>::iterator::iterator(CompactAVLTree<Key, Value>* tree, uint32_t index) :
+    tree_(tree), current_(index)
+{
+
+}
+
+template<class Key, class Value>
+CompactAVLTree<Key, Value>::iterator::iterator() :
+    tree_(NULL), current_(NIL)
+{
+
+}
+
+template<class Key, class Value>
+std::pair<const Key,Value> &
+CompactAVLTree<Key, Value>::iterator::operator*() const
+{
+    return tree_->pool_[current_].item;
+}
+
+template<class Key, class Value>
+std::pair<const Key,Value> *
+CompactAVLTree<Key, Value>::iterator::operator->() const
+{
+    return &(tree_->pool_[current_].item);
+}
+
+template<class Key, class Value>
+bool
+CompactAVLTree<Key, Value>::iterator::operator==(const iterator& rhs) const
+{
+    return current_ == rhs.current_;
+}
+
+template<class Key, class Value>
+bool
+CompactAVLTree<Key, Value>::iterator::operator!=(const iterator& rhs) const
+{
+    return current_ != rhs.current_;
+}
+
+template<class Key, class Value>
+typename CompactAVLTree<Key, Value>::iterator&
+CompactAVLTree<Key, Value>::iterator::operator++()
+{
+    current_ = tree_->successor(current_);
+    return *this;
+}
+
+/*
+-------------------------------------------------------------
+End implementations for the CompactAVLTree::iterator class.
+-------------------------------------------------------------
+*/
+
+/*
+-----------------------------------------------------
+Begin implementations for the CompactAVLTree class.
+-----------------------------------------------------
+*/
+
+template<class Key, class Value>
+CompactAVLTree<Key, Value>::CompactAVLTree() :
+    root_(NIL), free_(NIL), freeCount_(0)
+{
+
+}
+
+template<class Key, class Value>
+CompactAVLTree<Key, Value>::~CompactAVLTree()
+{
+
+}
+
+template<class Key, class Value>
+bool CompactAVLTree<Key, Value>::empty() const
+{
+    return root_ == NIL;
+}
+
+template<class Key, class Value>
+size_t CompactAVLTree<Key, Value>::size() const
+{
+    return pool_.size() - freeCount_;
+}
+
+template<class Key, class Value>
+void CompactAVLTree<Key, Value>::reserve(size_t n)
+{
+    pool_.reserve(n);
+}
+
+template<class Key, class Value>
+size_t CompactAVLTree<Key, Value>::memoryUsage() const
+{
+    return pool_.capacity() * sizeof(NodeType);
+}
+
+/**
+* Prints the contents in key order, one (key, value) pair per line.
+*/
+template<class Key, class Value>
+void CompactAVLTree<Key, Value>::print() const
+{
+    if(empty())
+    {
+        std::cout << "<empty tree>" << std::endl;
+        return;
+    }
+    for(iterator it = begin(); it != end(); ++it)
+        std::cout << '(' << it->first << ", " << it->second << ')' << std::endl;
+    std::cout << "\n";
+}
+
+template<class Key, class Value>
+typename CompactAVLTree<Key, Value>::iterator
+CompactAVLTree<Key, Value>::begin() const
+{
+    return iterator(const_cast<CompactAVLTree<Key, Value>*>(this), getSmallestNode());
+}
+
+template<class Key, class Value>
+typename CompactAVLTree<Key, Value>::iterator
+CompactAVLTree<Key, Value>::end() const
+{
+    return iterator(const_cast<CompactAVLTree<Key, Value>*>(this), NIL);
+}
+
+template<class Key, class Value>
+typename CompactAVLTree<Key, Value>::iterator
+CompactAVLTree<Key, Value>::find(const Key& key) const
+{
+    return iterator(const_cast<CompactAVLTree<Key, Value>*>(this), internalFind(key));
+}
+
+/**
+ * @precondition The key exists in the map
+ * Returns the value associated with the key
+ */
+template<class Key, class Value>
+Value& CompactAVLTree<Key, Value>::operator[](const Key& key)
+{
+    uint32_t curr = internalFind(key);
+    if(curr == NIL) throw std::out_of_range("Invalid key");
+    return pool_[curr].item.second;
+}
+
+template<class Key, class Value>
+Value const & CompactAVLTree<Key, Value>::operator[](const Key& key) const
+{
+    uint32_t curr = internalFind(key);
+    if(curr == NIL) throw std::out_of_range("Invalid key");
+    return pool_[curr].item.second;
+}
+
+/**
+* Inserts into the pool, then retraces towards the root adjusting balances until a
+* subtree's height stops changing or one rotation restores the balance.
+* If the key is already in the tree its value is overwritten.
+*/
+template<class Key, class Value>
+void CompactAVLTree<Key, Value>::insert(const std::pair<const Key, Value>& keyValuePair)
+{
+    if(root_ == NIL)
+    {
+        root_ = acquireNode(keyValuePair.first, keyValuePair.second, NIL);
+        return;
+    }
+
+    uint32_t cur = root_;
+    while(true)
+    {
+        NodeType& node = pool_[cur];
+        if(keyValuePair.first < node.item.first)
+        {
+            if(node.left == NIL) break;
+            cur = node.left;
+        }
+        else if(node.item.first < keyValuePair.first)
+        {
+            if(node.right == NIL) break;
+            cur = node.right;
+        }
+        else
+        {
+            node.item.second = keyValuePair.second;
+            return;
+        }
+    }
+
+    uint32_t n = acquireNode(keyValuePair.first, keyValuePair.second, cur);
+    if(keyValuePair.first < pool_[cur].item.first) pool_[cur].left = n;
+    else pool_[cur].right = n;
+
+    uint32_t child = n;
+    uint32_t p = cur;
+    while(p != NIL)
+    {
+        int b = pool_[p].balance() + (pool_[p].left == child ? -1 : 1);
+        if(b == 0)
+        {
+            pool_[p].setBalance(0);
+            break;
+        }
+        if(b == 1 || b == -1)
+        {
+            pool_[p].setBalance(b);
+            child = p;
+            p = pool_[p].parent();
+            continue;
+        }
+        rebalance(p, b);
+        break;
+    }
+}
+
+/**
+* Removes the key. A node with two children first trades places in the tree with its
+* predecessor, which has no right child. Balances are then retraced from the unlinked
+* node's parent.
+*/
+template<class Key, class Value>
+void CompactAVLTree<Key, Value>::remove(const Key& key)
+{
+    uint32_t d = internalFind(key);
+    if(d == NIL) return;
+
+    if(pool_[d].left != NIL && pool_[d].right != NIL)
+    {
+        uint32_t pred = pool_[d].left;
+        while(pool_[pred].right != NIL) pred = pool_[pred].right;
+        swapWithPredecessor(d, pred);
+    }
+
+    uint32_t child = pool_[d].left != NIL ? pool_[d].left : pool_[d].right;
+    uint32_t p = pool_[d].parent();
+    bool fromLeft = (p != NIL && pool_[p].left == d);
+    if(child != NIL) pool_[child].setParent(p);
+    replaceChild(p, d, child);
+
+    while(p != NIL)
+    {
+        int b = pool_[p].balance() + (fromLeft ? 1 : -1);
+        uint32_t top = p;
+        if(b == 1 || b == -1)
+        {
+            pool_[p].setBalance(b);
+            break;
+        }
+        if(b == 0)
+        {
+            pool_[p].setBalance(0);
+        }
+        else
+        {
+            top = rebalance(p, b);
+            // the subtree kept its height, nothing above it changes
+            if(pool_[top].balance() != 0) break;
+        }
+        p = pool_[top].parent();
+        if(p != NIL) fromLeft = (pool_[p].left == top);
+    }
+
+    releaseNode(d);
+}
+
+template<class Key, class Value>
+uint32_t CompactAVLTree<Key, Value>::acquireNode(const Key& key, const Value& value, uint32_t parent)
+{
+    if(free_ == NIL)
+    {
+        if(pool_.size() >= NIL) throw std::length_error("CompactAVLTree is full");
+        pool_.push_back(NodeType(key, value, parent));
+        return (uint32_t)pool_.size() - 1;
+    }
+    uint32_t n = free_;
+    uint32_t next = pool_[n].left;
+    pool_[n].~NodeType();
+    new (&pool_[n]) NodeType(key, value, parent);
+    free_ = next;
+    --freeCount_;
+    return n;
+}
+
+template<class Key, class Value>
+void CompactAVLTree<Key, Value>::releaseNode(uint32_t n)
+{
+    pool_[n].left = free_;
+    pool_[n].right = NIL;
+    free_ = n;
+    ++freeCount_;
+}
+
+/**
+* The links are swapped, not the items, so both nodes keep their slots. pred is the
+* rightmost node of n's left subtree, possibly n's left child itself.
+*/
+template<class Key, class Value>
+void CompactAVLTree<Key, Value>::swapWithPredecessor(uint32_t n, uint32_t pred)
+{
+    uint32_t np = pool_[n].parent();
+    uint32_t nl = pool_[n].left;
+    uint32_t nr = pool_[n].right;
+    int nb = pool_[n].balance();
+    uint32_t pp = pool_[pred].parent();
+    uint32_t pl = pool_[pred].left;
+    int pb = pool_[pred].balance();
+
+    replaceChild(np, n, pred);
+    pool_[pred].setParent(np);
+    pool_[pred].right = nr;
+    pool_[nr].setParent(pred);
+    if(pp == n)
+    {
+        pool_[pred].left = n;
+        pool_[n].setParent(pred);
+    }
+    else
+    {
+        pool_[pred].left = nl;
+        pool_[nl].setParent(pred);
+        pool_[pp].right = n;
+        pool_[n].setParent(pp);
+    }
+    pool_[n].left = pl;
+    if(pl != NIL) pool_[pl].setParent(n);
+    pool_[n].right = NIL;
+    pool_[n].setBalance(pb);
+    pool_[pred].setBalance(nb);
+}
+
+template<class Key, class Value>
+void CompactAVLTree<Key, Value>::replaceChild(uint32_t parent, uint32_t oldChild, uint32_t newChild)
+{
+    if(parent == NIL) root_ = newChild;
+    else if(pool_[parent].left == oldChild) pool_[parent].left = newChild;
+    else pool_[parent].right = newChild;
+}
+
+/**
+* Link-level rotations; they return the new subtree root and leave balances to rebalance().
+*/
+template<class Key, class Value>
+uint32_t CompactAVLTree<Key, Value>::rotateLeft(uint32_t x)
+{
+    uint32_t y = pool_[x].right;
+    uint32_t p = pool_[x].parent();
+    pool_[x].right = pool_[y].left;
+    if(pool_[y].left != NIL) pool_[pool_[y].left].setParent(x);
+    pool_[y].left = x;
+    pool_[x].setParent(y);
+    pool_[y].setParent(p);
+    replaceChild(p, x, y);
+    return y;
+}
+
+template<class Key, class Value>
+uint32_t CompactAVLTree<Key, Value>::rotateRight(uint32_t x)
+{
+    uint32_t y = pool_[x].left;
+    uint32_t p = pool_[x].parent();
+    pool_[x].left = pool_[y].right;
+    if(pool_[y].right != NIL) pool_[pool_[y].right].setParent(x);
+    pool_[y].right = x;
+    pool_[x].setParent(y);
+    pool_[y].setParent(p);
+    replaceChild(p, x, y);
+    return y;
+}
+
+/**
+* Fixes node x whose balance would be bx (+2 or -2, which does not fit in the packed
+* field) with a single or double rotation. Returns the new root of the subtree.
+*/
+template<class Key, class Value>
+uint32_t CompactAVLTree<Key, Value>::rebalance(uint32_t x, int bx)
+{
+    if(bx > 0)
+    {
+        uint32_t y = pool_[x].right;
+        int by = pool_[y].balance();
+        if(by >= 0)
+        {
+            rotateLeft(x);
+            pool_[x].setBalance(by == 0 ? 1 : 0);
+            pool_[y].setBalance(by == 0 ? -1 : 0);
+            return y;
+        }
+        uint32_t z = pool_[y].left;
+        int bz = pool_[z].balance();
+        rotateRight(y);
+        rotateLeft(x);
+        pool_[x].setBalance(bz == 1 ? -1 : 0);
+        pool_[y].setBalance(bz == -1 ? 1 : 0);
+        pool_[z].setBalance(0);
+        return z;
+    }
+    else
+    {
+        uint32_t y = pool_[x].left;
+        int by = pool_[y].balance();
+        if(by <= 0)
+        {
+            rotateRight(x);
+            pool_[x].setBalance(by == 0 ? -1 : 0);
+            pool_[y].setBalance(by == 0 ? 1 : 0);
+            return y;
+        }
+        uint32_t z = pool_[y].right;
+        int bz = pool_[z].balance();
+        rotateLeft(y);
+        rotateRight(x);
+        pool_[x].setBalance(bz == -1 ? 1 : 0);
+        pool_[y].setBalance(bz == 1 ? -1 : 0);
+        pool_[z].setBalance(0);
+        return z;
+    }
+}
+
+/**
+* Removes everything. Since all nodes live in the pool this is a single deallocation.
+*/
+template<class Key, class Value>
+void CompactAVLTree<Key, Value>::clear()
+{
+    std::vector<NodeType>().swap(pool_);
+    root_ = NIL;
+    free_ = NIL;
+    freeCount_ = 0;
+}
+
+template<class Key, class Value>
+uint32_t CompactAVLTree<Key, Value>::getSmallestNode() const
+{
+    uint32_t cur = root_;
+    if(cur == NIL) return NIL;
+    while(pool_[cur].left != NIL) cur = pool_[cur].left;
+    return cur;
+}
+
+template<class Key, class Value>
+uint32_t CompactAVLTree<Key, Value>::successor(uint32_t current) const
+{
+    if(pool_[current].right != NIL)
+    {
+        current = pool_[current].right;
+        while(pool_[current].left != NIL) current = pool_[current].left;
+        return current;
+    }
+    uint32_t p = pool_[current].parent();
+    while(p != NIL && pool_[p].right == current)
+    {
+        current = p;
+        p = pool_[p].parent();
+    }
+    return p;
+}
+
+template<class Key, class Value>
+uint32_t CompactAVLTree<Key, Value>::internalFind(const Key& key) const
+{
+    uint32_t cur = root_;
+    while(cur != NIL)
+    {
+        const NodeType& node = pool_[cur];
+        if(key < node.item.first) cur = node.left;
+        else if(node.item.first < key) cur = node.right;
+        else return cur;
+    }
+    return NIL;
+}
+
+/**
+ * Return true iff the tree is balanced. Heights are recomputed rather than trusting
+ * the stored balance factors.
+ */
+template<class Key, class Value>
+bool CompactAVLTree<Key, Value>::isBalanced() const
+{
+    return height(root_) >= 0;
+}
+
+// Height of the subtree at n, or -1 if some node in it is out of balance.
+template<class Key, class Value>
+int CompactAVLTree<Key, Value>::height(uint32_t n) const
+{
+    if(n == NIL) return 0;
+    int l = height(pool_[n].left);
+    int r = height(pool_[n].right);
+    if(l < 0 || r < 0 || abs(l - r) > 1) return -1;
+    return (l > r ? l : r) + 1;
+}
+
+/*
+---------------------------------------------------
+End implementations for the CompactAVLTree class.
+---------------------------------------------------
+*/
+
+#endif
@@ -0,0 +1,78 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cstdlib>
+#include "bench_utils.h"
+#include "avlbst.h"
+
+using namespace std;
+
+// AVLTree::Cursor::seek() against find() for lookups that stay close together.
+//
+// usage: cursor-bench [entries] [lookups]
+//
+// The tree holds the even keys below 2 * entries. A window width values wide slides
+// forward by one value per lookup, wrapping at the end, and each lookup asks for a
+// random value inside it, so consecutive lookups land about width / 2 entries apart;
+// the odd values miss. Width 1 is a sequential scan and the last width, 2 * entries,
+// is uniform random access.
+
+static const size_t WIDTHS[] = { 1, 16, 256, 4096, 65536 };
+
+static double run(const AVLTree<int, int>& tree, const vector<int>& probes, bool useCursor)
+{
+	AVLTree<int, int>::Cursor cursor = tree.cursor();
+	size_t hits = 0;
+	Stopwatch watch;
+	if(useCursor)
+	{
+		for(size_t i = 0; i < probes.size(); i++)
+			if(cursor.seek(probes[i]) != tree.end()) hits++;
+	}
+	else
+	{
+		for(size_t i = 0; i < probes.size(); i++)
+			if(tree.find(probes[i]) != tree.end()) hits++;
+	}
+	double secs = watch.seconds();
+	if(hits == 0) cerr << "no hits" << endl;
+	return probes.size() / secs;
+}
+
+static void report(const AVLTree<int, int>& tree, size_t n, size_t lookups, size_t width)
+{
+	mt19937 rng(45);
+	vector<int> probes(lookups);
+	for(size_t i = 0; i < lookups; i++)
+		probes[i] = (int)(((i % n) + rng() % width) % (2 * n));
+
+	double plain = run(tree, probes, false);
+	double seek = run(tree, probes, true);
+	cout << "  window " << width << endl;
+	cout << "    find() lookups/s:   " << (uint64_t)plain << endl;
+	cout << "    seek() lookups/s:   " << (uint64_t)seek << " (" << seek / plain << "x)" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+	size_t lookups = argc > 2 ? strtoul(argv[2], NULL, 10) : 4000000;
+	if(n == 0)
+	{
+		cerr << "usage: " << argv[0] << " [entries > 0] [lookups]" << endl;
+		return 1;
+	}
+
+	mt19937 rng(45);
+	vector<int> keys(n);
+	for(size_t i = 0; i < n; i++) keys[i] = (int)(2 * i);
+	shuffle(keys.begin(), keys.end(), rng);
+	AVLTree<int, int> tree;
+	for(size_t i = 0; i < n; i++) tree.insert(make_pair(keys[i], (int)i));
+
+	cout << "AVLTree<int,int> with " << n << " entries" << endl;
+	for(size_t w = 0; w < sizeof(WIDTHS) / sizeof(WIDTHS[0]); w++)
+		report(tree, n, lookups, WIDTHS[w]);
+	report(tree, n, lookups, 2 * n);
+	return 0;
+}
@@ -0,0 +1,138 @@
+#include <iostream>
+#include <streambuf>
+#include <cstdlib>
+#include "bench_utils.h"
+#include "bst.h"
+
+using namespace std;
+
+// Runs every whole-tree operation on a BinarySearchTree fed sorted keys, which
+// degenerates into a list as deep as it is long. Each of them has to finish in
+// bounded stack, so a recursive one would crash here long before the end.
+//
+// usage: deep-test [entries]
+//
+// The first keys go in through insert(). insert() walks the whole list for every
+// sorted key, so the rest are linked where it would put them, keeping the run O(n).
+
+class DeepTree : public BinarySearchTree<int, int>
+{
+public:
+    DeepTree() : last_(NULL) { }
+
+    // where insert() would hang a key larger than all the others
+    void append(int key, int value)
+    {
+        Node<int, int>* n = new Node<int, int>(key, value, last_);
+        if(last_ == NULL) root_ = n;
+        else last_->setRight(n);
+        rememberKey(key);
+        last_ = n;
+    }
+
+    void insertTracked(int key, int value)
+    {
+        insert(make_pair(key, value));
+        last_ = last_ == NULL ? root_ : last_->getRight();
+    }
+
+protected:
+    Node<int, int>* last_;
+};
+
+// counts what is written to it and throws it away
+class CountingBuf : public streambuf
+{
+public:
+    CountingBuf() : bytes(0) { }
+    size_t bytes;
+
+protected:
+    virtual int_type overflow(int_type ch) { bytes++; return traits_type::not_eof(ch); }
+    virtual streamsize xsputn(const char*, streamsize n) { bytes += n; return n; }
+};
+
+struct SumValues
+{
+    void operator()(long long& sum, pair<const int, int>& entry) const { sum += entry.second; }
+};
+
+struct AddSums
+{
+    void operator()(long long& into, const long long& from) const { into += from; }
+};
+
+static int failures = 0;
+
+static void check(bool ok, const char* what)
+{
+    if(!ok)
+    {
+        cout << "FAILED: " << what << endl;
+        failures++;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    long n = argc > 1 ? strtol(argv[1], NULL, 10) : 10000000;
+    if(n < 10000)
+    {
+        cerr << "usage: " << argv[0] << " [entries >= 10000]" << endl;
+        return 1;
+    }
+
+    Stopwatch watch;
+    DeepTree tree;
+    for(int i = 0; i < 10000; i++) tree.insertTracked(i, i);
+    for(int i = 10000; i < n; i++) tree.append(i, i);
+    cout << n << " sorted keys in " << watch.seconds() << " s" << endl;
+
+    watch.restart();
+    TreeProfile profile = tree.profile();
+    check(profile.height == n && profile.leaves == 1 && !profile.balanced && profile.equalPaths, "profile()");
+    check(!tree.isBalanced(), "isBalanced()");
+    check(tree.stats().height == n, "stats()");
+    cout << "profile(), isBalanced(), stats(): " << watch.seconds() << " s" << endl;
+
+    watch.restart();
+    tree.print();
+    cout << "print(): " << watch.seconds() << " s" << endl;
+
+    watch.restart();
+    CountingBuf dotBuf, jsonBuf;
+    ostream dot(&dotBuf), json(&jsonBuf);
+    tree.exportDot(dot);
+    tree.exportJsonLines(json);
+    check(dotBuf.bytes > (size_t)n && jsonBuf.bytes > (size_t)n, "exportDot(), exportJsonLines()");
+    cout << "exportDot(), exportJsonLines(): " << watch.seconds() << " s" << endl;
+
+    watch.restart();
+    long long sum = 0;
+    long count = 0;
+    for(BinarySearchTree<int, int>::iterator it = tree.begin(); it != tree.end(); ++it)
+    {
+        sum += it->second;
+        count++;
+    }
+    check(count == n && sum == (long long)n * (n - 1) / 2, "iterator");
+    check(tree.parallelReduce(0LL, SumValues(), AddSums(), 4, true) == sum, "parallelReduce()");
+    cout << "iterator, parallelReduce(): " << watch.seconds() << " s" << endl;
+
+    watch.restart();
+    check(tree.find((int)n - 1) != tree.end() && tree[(int)n - 1] == (int)n - 1, "find(), operator[]");
+    tree.setBloomFilter(10, 1);
+    check(tree.find(-1) == tree.end() && tree.bloomFilterStats().rejected == 1, "setBloomFilter()");
+    tree.remove((int)n - 1);
+    tree.remove(0);
+    check(tree.find(0) == tree.end() && tree.find((int)n - 1) == tree.end() && tree.profile().height == n - 2, "remove()");
+    cout << "find(), setBloomFilter(), remove(): " << watch.seconds() << " s" << endl;
+
+    watch.restart();
+    tree.clear();
+    check(tree.empty(), "clear()");
+    cout << "clear(): " << watch.seconds() << " s" << endl;
+
+    cout << (failures == 0 ? "PASSED" : "FAILED") << endl;
+    return failures == 0 ? 0 : 1;
+}
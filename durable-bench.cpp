@@ -0,0 +1,84 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <unistd.h>
+#include "durable_avl.h"
+
+using namespace std;
+
+// Sustained write throughput and recovery time for DurableAVLTree.
+//
+// usage: durable-bench [ops] [path prefix] [--sync-every-op]
+//
+// Runs <ops> operations (80% insert, 20% remove over a key space of ops/2 keys),
+// waits for them to be durable, then drops the tree and times recovery from disk.
+
+static void removeFiles(const string& prefix)
+{
+	std::remove((prefix + ".ckpt").c_str());
+	std::remove((prefix + ".ckpt.tmp").c_str());
+	// segments older than the last checkpoint are already gone, so keep looking
+	// for a while past the first missing generation
+	for(int gen = 0, misses = 0; misses < 1024; gen++)
+	{
+		if(std::remove((prefix + ".log." + to_string(gen)).c_str()) != 0) misses++;
+		else misses = 0;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	uint64_t ops = 10000000;
+	string prefix = "/tmp/durable-bench";
+	DurableOptions opts;
+
+	int pos = 0;
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--sync-every-op") == 0) opts.syncEveryOp = true;
+		else if(pos++ == 0) ops = strtoull(argv[i], NULL, 10);
+		else prefix = argv[i];
+	}
+
+	removeFiles(prefix);
+	mt19937_64 rng(104);
+	uniform_int_distribution<int> keys(0, (int)(ops / 2));
+	uniform_int_distribution<int> mix(0, 99);
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	uint64_t syncs;
+	{
+		DurableAVLTree<int, int> tree(prefix, opts);
+		for(uint64_t i = 0; i < ops; i++)
+		{
+			int k = keys(rng);
+			if(mix(rng) < 80) tree.insert(make_pair(k, (int)i));
+			else tree.remove(k);
+		}
+		tree.sync();
+		syncs = tree.syncCount();
+		tree.waitForCheckpoint();
+	}
+	double writeSecs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	start = chrono::steady_clock::now();
+	uint64_t replayed;
+	{
+		DurableAVLTree<int, int> tree(prefix, opts);
+		replayed = tree.recoveredOps();
+	}
+	double recoverSecs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	cout << "operations:        " << ops << endl;
+	cout << "write time (s):    " << writeSecs << endl;
+	cout << "write ops/s:       " << (uint64_t)(ops / writeSecs) << endl;
+	cout << "fsyncs:            " << syncs << " (" << (double)ops / (syncs ? syncs : 1) << " ops per fsync)" << endl;
+	cout << "recovery time (s): " << recoverSecs << endl;
+	cout << "log records replayed during recovery: " << replayed << endl;
+
+	removeFiles(prefix);
+	return 0;
+}
@@ -0,0 +1,773 @@
+#ifndef DURABLE_AVL_H
+#define DURABLE_AVL_H
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <stdexcept>
+#include <exception>
+#include <type_traits>
+#include <cstring>
+#include <cstdio>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include "avlbst.h"
+
+/**
+* Tuning knobs for a DurableAVLTree.
+*
+* groupCommitBytes/groupCommitInterval decide how many operations share one fsync:
+* the log writer flushes once either limit is reached. checkpointEveryOps is how many
+* logged operations are allowed to pile up before a background checkpoint is taken
+* (0 disables automatic checkpoints).
+*/
+struct DurableOptions
+{
+    DurableOptions() :
+        groupCommitBytes(1 << 20),
+        groupCommitInterval(std::chrono::milliseconds(5)),
+        checkpointEveryOps(1000000),
+        syncEveryOp(false)
+    {
+
+    }
+
+    size_t groupCommitBytes;
+    std::chrono::milliseconds groupCommitInterval;
+    uint64_t checkpointEveryOps;
+    // fsync before every insert/remove returns (the old behaviour, for comparison)
+    bool syncEveryOp;
+};
+
+/**
+* An AVL tree whose contents survive a crash.
+*
+* Every change is appended to a write-ahead log (<path>.log.<gen>): insert() and
+* remove() one record each, insertBatch(), eraseBatch() and buildParallel() one record
+* per pair or key, handed to the log together, and clear() a record of its own. A
+* background writer thread batches the appended records and makes them durable with
+* one fdatasync per group, so callers never wait on the disk unless they ask to with
+* sync().
+* Periodically the full tree is copied and written out by a second background thread
+* as <path>.ckpt; once that checkpoint is on disk the log segments it covers are deleted.
+*
+* On construction the tree recovers by loading the last checkpoint and replaying every
+* log segment written after it. Records are checksummed, so a torn write at the end of
+* a segment is detected and ignored.
+*
+* Keys and values are written as raw bytes, so both must be trivially copyable. A value
+* written through an iterator is not logged, so the non-const operator[] is hidden and
+* values are changed with insert(). The batch, build and hinted insert calls are not
+* virtual: made through an AVLTree reference they are AVLTree's and are not logged.
+*
+* I/O errors on the background threads are kept, not thrown there: a failed log write
+* or fdatasync is rethrown by every later sync() (and by insert/remove with
+* syncEveryOp), and nothing is logged after it. A failed checkpoint is rethrown once by
+* waitForCheckpoint(); the log segments it would have replaced are kept.
+*/
+template <class Key, class Value>
+class DurableAVLTree : public AVLTree<Key, Value>
+{
+public:
+    typedef typename AVLTree<Key, Value>::iterator iterator;
+
+    DurableAVLTree(const std::string& path, const DurableOptions& opts = DurableOptions());
+    virtual ~DurableAVLTree();
+
+    virtual void insert (const std::pair<const Key, Value> &new_item);
+    virtual void remove(const Key& key);
+    iterator insert(iterator hint, const std::pair<const Key, Value>& new_item);
+    // AVLTree's versions, logged as one insert or remove per pair or key in batch order,
+    // which replays to the same tree since the last of a key's pairs wins either way
+    template<typename InputIt> void insertBatch(InputIt first, InputIt last);
+    template<typename InputIt> void eraseBatch(InputIt first, InputIt last);
+    template<typename InputIt> void buildParallel(InputIt first, InputIt last, unsigned threads = 0);
+    virtual void clear() override;
+
+    using BinarySearchTree<Key, Value>::operator[];
+
+    // Blocks until every operation issued so far is on disk. Throws if the log writer
+    // has failed.
+    void sync();
+    // Starts a background checkpoint (no-op if one is already running).
+    void checkpoint();
+    // Blocks until the running checkpoint, if any, has been written. Throws if a
+    // checkpoint failed since the last call.
+    void waitForCheckpoint();
+
+    // Number of log records replayed during recovery.
+    uint64_t recoveredOps() const;
+    // Number of fdatasync calls issued by the log writer.
+    uint64_t syncCount() const;
+
+private:
+    // not defined: a write through the returned reference would not be logged
+    Value& operator[](const Key& key);
+
+protected:
+    enum LogOp { LOG_INSERT = 1, LOG_REMOVE = 2, LOG_CLEAR = 3 };
+
+    static const uint32_t CKPT_MAGIC = 0x54504b43; // "CKPT"
+    static const size_t RECORD_SIZE = 1 + sizeof(Key) + sizeof(Value) + sizeof(uint32_t);
+
+    static uint32_t checksum(const char* data, size_t len);
+    std::string segmentName(uint64_t gen) const;
+    std::string checkpointName() const;
+
+    void recover();
+    void createSegment(uint64_t gen);
+    void syncDirectory();
+    bool loadCheckpoint(uint64_t& gen);
+    bool replaySegment(uint64_t gen);
+    // key or value NULL leaves its bytes zero
+    static void encodeRecord(char* rec, uint8_t op, const Key* key, const Value* value);
+    void appendRecord(uint8_t op, const Key* key, const Value* value);
+    void appendRecords(const char* recs, size_t count);
+    void writerLoop();
+    void writeBatch(uint64_t gen, const std::vector<char>& batch);
+    void checkpointLoop();
+    void writeCheckpoint(uint64_t gen, const std::vector<std::pair<Key, Value> >& items);
+    static void writeAll(int fd, const char* data, size_t len);
+
+    std::string path_;
+    DurableOptions opts_;
+
+    // log writer state, guarded by logMutex_
+    mutable std::mutex logMutex_;
+    std::condition_variable logCv_;
+    std::condition_variable durableCv_;
+    std::vector<char> pending_;
+    uint64_t appendedSeq_;
+    uint64_t durableSeq_;
+    uint64_t currentGen_;
+    uint64_t syncs_;
+    bool flushNow_;
+    bool stop_;
+    int fd_;
+    uint64_t fdGen_;
+    std::exception_ptr logError_;
+
+    // checkpoint state, guarded by ckptMutex_
+    std::mutex ckptMutex_;
+    std::condition_variable ckptCv_;
+    std::vector<std::pair<Key, Value> > snapshot_;
+    uint64_t snapshotGen_;
+    bool ckptPending_;
+    bool ckptStop_;
+    std::exception_ptr ckptError_;
+
+    uint64_t opsSinceCheckpoint_;
+    uint64_t recovered_;
+
+    std::thread writer_;
+    std::thread checkpointer_;
+};
+
+/*
+  -----------------------------------------------
+  Begin implementations for the DurableAVLTree class.
+  -----------------------------------------------
+*/
+
+template<class Key, class Value>
+DurableAVLTree<Key, Value>::DurableAVLTree(const std::string& path, const DurableOptions& opts) :
+    path_(path),
+    opts_(opts),
+    appendedSeq_(0),
+    durableSeq_(0),
+    currentGen_(0),
+    syncs_(0),
+    flushNow_(false),
+    stop_(false),
+    fd_(-1),
+    fdGen_(0),
+    snapshotGen_(0),
+    ckptPending_(false),
+    ckptStop_(false),
+    opsSinceCheckpoint_(0),
+    recovered_(0)
+{
+    static_assert(std::is_trivially_copyable<Key>::value, "DurableAVLTree keys must be trivially copyable");
+    static_assert(std::is_trivially_copyable<Value>::value, "DurableAVLTree values must be trivially copyable");
+    recover();
+    writer_ = std::thread(&DurableAVLTree<Key, Value>::writerLoop, this);
+    checkpointer_ = std::thread(&DurableAVLTree<Key, Value>::checkpointLoop, this);
+}
+
+/**
+* Makes everything durable, then shuts the background threads down. A log failure
+* cannot be reported from here; callers who need to know call sync() first.
+*/
+template<class Key, class Value>
+DurableAVLTree<Key, Value>::~DurableAVLTree()
+{
+    try
+    {
+        sync();
+    }
+    catch(...)
+    {
+
+    }
+    {
+        std::lock_guard<std::mutex> lock(ckptMutex_);
+        ckptStop_ = true;
+    }
+    ckptCv_.notify_all();
+    checkpointer_.join();
+    {
+        std::lock_guard<std::mutex> lock(logMutex_);
+        stop_ = true;
+    }
+    logCv_.notify_all();
+    writer_.join();
+    if(fd_ >= 0) ::close(fd_);
+    // The in-memory tree is torn down by ~BinarySearchTree without being logged,
+    // since virtual calls there resolve to the base class.
+}
+
+template<class Key, class Value>
+void DurableAVLTree<Key, Value>::insert (const std::pair<const Key, Value> &new_item)
+{
+    AVLTree<Key, Value>::insert(new_item);
+    appendRecord(LOG_INSERT, &new_item.first, &new_item.second);
+}
+
+template<class Key, class Value>
+void DurableAVLTree<Key, Value>::remove(const Key& key)
+{
+    AVLTree<Key, Value>::remove(key);
+    appendRecord(LOG_REMOVE, &key, NULL);
+}
+
+template<class Key, class Value>
+typename DurableAVLTree<Key, Value>::iterator DurableAVLTree<Key, Value>::insert(iterator hint, const std::pair<const Key, Value>& new_item)
+{
+    iterator it = AVLTree<Key, Value>::insert(hint, new_item);
+    appendRecord(LOG_INSERT, &new_item.first, &new_item.second);
+    return it;
+}
+
+template<class Key, class Value>
+template<typename InputIt>
+void DurableAVLTree<Key, Value>::insertBatch(InputIt first, InputIt last)
+{
+    std::vector<std::pair<Key, Value> > batch(first, last);
+    AVLTree<Key, Value>::insertBatch(batch.begin(), batch.end());
+    std::vector<char> recs(batch.size() * RECORD_SIZE);
+    for(size_t i = 0; i < batch.size(); ++i)
+        encodeRecord(&recs[i * RECORD_SIZE], LOG_INSERT, &batch[i].first, &batch[i].second);
+    appendRecords(recs.data(), batch.size());
+}
+
+template<class Key, class Value>
+template<typename InputIt>
+void DurableAVLTree<Key, Value>::eraseBatch(InputIt first, InputIt last)
+{
+    std::vector<Key> batch(first, last);
+    AVLTree<Key, Value>::eraseBatch(batch.begin(), batch.end());
+    std::vector<char> recs(batch.size() * RECORD_SIZE);
+    for(size_t i = 0; i < batch.size(); ++i)
+        encodeRecord(&recs[i * RECORD_SIZE], LOG_REMOVE, &batch[i], NULL);
+    appendRecords(recs.data(), batch.size());
+}
+
+template<class Key, class Value>
+template<typename InputIt>
+void DurableAVLTree<Key, Value>::buildParallel(InputIt first, InputIt last, unsigned threads)
+{
+    std::vector<std::pair<Key, Value> > batch(first, last);
+    AVLTree<Key, Value>::buildParallel(batch.begin(), batch.end(), threads);
+    std::vector<char> recs(batch.size() * RECORD_SIZE);
+    for(size_t i = 0; i < batch.size(); ++i)
+        encodeRecord(&recs[i * RECORD_SIZE], LOG_INSERT, &batch[i].first, &batch[i].second);
+    appendRecords(recs.data(), batch.size());
+}
+
+/**
+* ~BinarySearchTree's clear() is the base class's, so tearing the tree down is not
+* logged.
+*/
+template<class Key, class Value>
+void DurableAVLTree<Key, Value>::clear()
+{
+    AVLTree<Key, Value>::clear();
+    appendRecord(LOG_CLEAR, NULL, NULL);
+}
+
+template<class Key, class Value>
+void DurableAVLTree<Key, Value>::encodeRecord(char* rec, uint8_t op, const Key* key, const Value* value)
+{
+    rec[0] = (char)op;
+    if(key != NULL) std::memcpy(rec + 1, key, sizeof(Key));
+    else std::memset(rec + 1, 0, sizeof(Key));
+    if(value != NULL) std::memcpy(rec + 1 + sizeof(Key), value, sizeof(Value));
+    else std::memset(rec + 1 + sizeof(Key), 0, sizeof(Value));
+    uint32_t sum = checksum(rec, RECORD_SIZE - sizeof(uint32_t));
+    std::memcpy(rec + RECORD_SIZE - sizeof(uint32_t), &sum, sizeof(uint32_t));
+}
+
+template<class Key, class Value>
+void DurableAVLTree<Key, Value>::appendRecord(uint8_t op, const Key* key, const Value* value)
+{
+    char rec[RECORD_SIZE];
+    encodeRecord(rec, op, key, value);
+    appendRecords(rec, 1);
+}
+
+/**
+* Adds count encoded records to the pending group under one lock, so a batch is never
+* split around another thread's records. The writer is woken when a group starts (to
+* arm the commit interval) and when it fills up, not once per record.
+*/
+template<class Key, class Value>
+void DurableAVLTree<Key, Value>::appendRecords(const char* recs, size_t count)
+{
+    if(count == 0) return;
+
+    uint64_t seq;
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(logMutex_);
+        wake = pending_.empty();
+        pending_.insert(pending_.end(), recs, recs + count * RECORD_SIZE);
+        seq = appendedSeq_ += count;
+        if(opts_.syncEveryOp) flushNow_ = true;
+        wake = wake || flushNow_ || pending_.size() >= opts_.groupCommitBytes;
+    }
+    if(wake) logCv_.notify_one();
+
+    if(opts_.syncEveryOp)
+    {
+        std::unique_lock<std::mutex> lock(logMutex_);
+        while(durableSeq_ < seq && !logError_) durableCv_.wait(lock);
+        if(durableSeq_ < seq) std::rethrow_exception(logError_);
+    }
+
+    opsSinceCheckpoint_ += count;
+    if(opts_.checkpointEveryOps != 0 && opsSinceCheckpoint_ >= opts_.checkpointEveryOps)
+        checkpoint();
+}
+
+template<class Key, class Value>
+void DurableAVLTree<Key, Value>::sync()
+{
+    std::unique_lock<std::mutex> lock(logMutex_);
+    uint64_t target = appendedSeq_;
+    if(durableSeq_ >= target) return;
+    if(logError_) std::rethrow_exception(logError_);
+    flushNow_ = true;
+    logCv_.notify_one();
+    while(durableSeq_ < target && !logError_) durableCv_.wait(lock);
+    if(durableSeq_ < target) std::rethrow_exception(logError_);
+}
+
+/**
+* The log writer. Sleeps until a group is full, a sync is requested or the commit
+* interval elapses, then writes the whole group and issues one fdatasync for it.
+* After a failed group the log can no longer be trusted, so later groups are dropped
+* and the error is left for sync() to throw.
+*/
+template<class Key, class Value>
+void DurableAVLTree<Key, Value>::writerLoop()
+{
+    std::vector<char> batch;
+    std::unique_lock<std::mutex> lock(logMutex_);
+    while(true)
+    {
+        while(!stop_ && !flushNow_ && pending_.size() < opts_.groupCommitBytes)
+        {
+            if(pending_.empty()) logCv_.wait(lock);
+            else if(logCv_.wait_for(lock, opts_.groupCommitInterval) == std::cv_status::timeout) break;
+        }
+        flushNow_ = false;
+        if(pending_.empty())
+        {
+            if(stop_) break;
+            continue;
+        }
+
+        if(logError_)
+        {
+            pending_.clear();
+            continue;
+        }
+
+        batch.swap(pending_);
+        uint64_t seq = appendedSeq_;
+        uint64_t gen = currentGen_;
+        lock.unlock();
+
+        std::exception_ptr error;
+        try
+        {
+            writeBatch(gen, batch);
+        }
+        catch(...)
+        {
+            error = std::current_exception();
+        }
+        batch.clear();
+
+        lock.lock();
+        if(error) logError_ = error;
+        else
+        {
+            durableSeq_ = seq;
+            ++syncs_;
+        }
+        durableCv_.notify_all();
+    }
+}
+
+template<class Key, class Value>
+void DurableAVLTree<Key, Value>::writeBatch(uint64_t gen, const std::vector<char>& batch)
+{
+    if(fd_ < 0 || fdGen_ != gen)
+    {
+        if(fd_ >= 0) ::close(fd_);
+        fd_ = ::open(segmentName(gen).c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if(fd_ < 0) throw std::runtime_error("DurableAVLTree: cannot open " + segmentName(gen));
+        fdGen_ = gen;
+    }
+    writeAll(fd_, batch.data(), batch.size());
+    if(::fdatasync(fd_) != 0) throw std::runtime_error("DurableAVLTree: fdatasync failed on " + segmentName(gen));
+}
+
+/**
+* Captures the current contents and hands them to the checkpoint thread. The log is
+* first made durable and then rotated to a new segment, so the checkpoint plus every
+* segment from the new generation on describes the tree exactly.
+*/
+template<class Key, class Value>
+void DurableAVLTree<Key, Value>::checkpoint()
+{
+    {
+        std::lock_guard<std::mutex> lock(ckptMutex_);
+        if(ckptPending_) return;
+    }
+    sync();
+
+    uint64_t gen;
+    {
+        std::lock_guard<std::mutex> lock(logMutex_);
+        gen = ++currentGen_;
+    }
+    createSegment(gen);
+
+    std::vector<std::pair<Key, Value> > items;
+    for(typename AVLTree<Key, Value>::iterator it = this->begin(); it != this->end(); ++it)
+        items.push_back(std::make_pair(it->first, it->second));
+
+    {
+        std::lock_guard<std::mutex> lock(ckptMutex_);
+        snapshot_.swap(items);
+        snapshotGen_ = gen;
+        ckptPending_ = true;
+    }
+    ckptCv_.notify_all();
+    opsSinceCheckpoint_ = 0;
+}
+
+template<class Key, class Value>
+void DurableAVLTree<Key, Value>::waitForCheckpoint()
+{
+    std::unique_lock<std::mutex> lock(ckptMutex_);
+    while(ckptPending_) ckptCv_.wait(lock);
+    if(ckptError_)
+    {
+        std::exception_ptr error = ckptError_;
+        ckptError_ = std::exception_ptr();
+        std::rethrow_exception(error);
+    }
+}
+
+template<class Key, class Value>
+void DurableAVLTree<Key, Value>::checkpointLoop()
+{
+    std::unique_lock<std::mutex> lock(ckptMutex_);
+    while(true)
+    {
+        while(!ckptPending_ && !ckptStop_) ckptCv_.wait(lock);
+        if(!ckptPending_) break;
+
+        std::vector<std::pair<Key, Value> > items;
+        items.swap(snapshot_);
+        uint64_t gen = snapshotGen_;
+        lock.unlock();
+
+        std::exception_ptr error;
+        try
+        {
+            writeCheckpoint(gen, items);
+        }
+        catch(...)
+        {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        if(error) ckptError_ = error;
+        ckptPending_ = false;
+        ckptCv_.notify_all();
+    }
+}
+
+/**
+* Writes the checkpoint to a temporary file and renames it into place, so a crash
+* mid-write leaves the previous checkpoint intact. Segments older than gen are
+* covered by the new checkpoint and are deleted once the rename itself is durable.
+*/
+template<class Key, class Value>
+void DurableAVLTree<Key, Value>::writeCheckpoint(uint64_t gen, const std::vector<std::pair<Key, Value> >& items)
+{
+    std::string tmp = checkpointName() + ".tmp";
+    int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0) throw std::runtime_error("DurableAVLTree: cannot open " + tmp);
+
+    try
+    {
+        uint64_t header[3] = { CKPT_MAGIC, gen, items.size() };
+        writeAll(fd, reinterpret_cast<const char*>(header), sizeof(header));
+
+        const size_t entry = sizeof(Key) + sizeof(Value);
+        std::vector<char> buf;
+        buf.reserve(entry * 4096);
+        uint32_t sum = checksum(reinterpret_cast<const char*>(header), sizeof(header));
+        for(size_t i = 0; i < items.size(); ++i)
+        {
+            size_t off = buf.size();
+            buf.resize(off + entry);
+            std::memcpy(&buf[off], &items[i].first, sizeof(Key));
+            std::memcpy(&buf[off + sizeof(Key)], &items[i].second, sizeof(Value));
+            sum ^= checksum(&buf[off], entry) + (uint32_t)i;
+            if(buf.size() >= entry * 4096)
+            {
+                writeAll(fd, buf.data(), buf.size());
+                buf.clear();
+            }
+        }
+        writeAll(fd, buf.data(), buf.size());
+        writeAll(fd, reinterpret_cast<const char*>(&sum), sizeof(sum));
+        if(::fsync(fd) != 0) throw std::runtime_error("DurableAVLTree: fsync failed on " + tmp);
+    }
+    catch(...)
+    {
+        ::close(fd);
+        ::unlink(tmp.c_str());
+        throw;
+    }
+    ::close(fd);
+
+    if(std::rename(tmp.c_str(), checkpointName().c_str()) != 0)
+        throw std::runtime_error("DurableAVLTree: cannot install " + checkpointName());
+    // the old segments are all that describe the tree until the new name is on disk
+    syncDirectory();
+
+    for(uint64_t old = gen; old-- > 0; )
+    {
+        if(::unlink(segmentName(old).c_str()) != 0) break;
+    }
+}
+
+/**
+* Rebuilds the tree from disk: the checkpoint first, then the log segments written
+* after it, in generation order. New operations go to a fresh segment.
+*/
+template<class Key, class Value>
+void DurableAVLTree<Key, Value>::recover()
+{
+    uint64_t gen = 0;
+    loadCheckpoint(gen);
+    while(replaySegment(gen)) ++gen;
+    currentGen_ = gen;
+    createSegment(gen);
+}
+
+/**
+* Segments are created as soon as their generation starts, even if nothing is logged
+* to them, so recovery can rely on the chain of generations having no gaps. The
+* directory is synced so that the new name survives a crash too.
+*/
+template<class Key, class Value>
+void DurableAVLTree<Key, Value>::createSegment(uint64_t gen)
+{
+    int fd = ::open(segmentName(gen).c_str(), O_WRONLY | O_CREAT, 0644);
+    if(fd < 0) throw std::runtime_error("DurableAVLTree: cannot create " + segmentName(gen));
+    ::close(fd);
+    syncDirectory();
+}
+
+/**
+* Creating, renaming and deleting files change the directory, not the files, so the
+* directory holding the log and checkpoint is fsynced on its own.
+*/
+template<class Key, class Value>
+void DurableAVLTree<Key, Value>::syncDirectory()
+{
+    size_t slash = path_.rfind('/');
+    std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : path_.substr(0, slash));
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if(fd < 0) throw std::runtime_error("DurableAVLTree: cannot open directory " + dir);
+    int rc = ::fsync(fd);
+    ::close(fd);
+    if(rc != 0) throw std::runtime_error("DurableAVLTree: fsync failed on directory " + dir);
+}
+
+template<class Key, class Value>
+bool DurableAVLTree<Key, Value>::loadCheckpoint(uint64_t& gen)
+{
+    FILE* f = std::fopen(checkpointName().c_str(), "rb");
+    if(f == NULL) return false;
+
+    uint64_t header[3];
+    if(std::fread(header, sizeof(header), 1, f) != 1 || header[0] != CKPT_MAGIC)
+    {
+        std::fclose(f);
+        throw std::runtime_error("DurableAVLTree: corrupt checkpoint " + checkpointName());
+    }
+
+    const size_t entry = sizeof(Key) + sizeof(Value);
+    std::vector<char> buf(entry);
+    uint32_t sum = checksum(reinterpret_cast<const char*>(header), sizeof(header));
+    for(uint64_t i = 0; i < header[2]; ++i)
+    {
+        if(std::fread(buf.data(), entry, 1, f) != 1)
+        {
+            std::fclose(f);
+            throw std::runtime_error("DurableAVLTree: truncated checkpoint " + checkpointName());
+        }
+        sum ^= checksum(buf.data(), entry) + (uint32_t)i;
+        Key k;
+        Value v;
+        std::memcpy(&k, buf.data(), sizeof(Key));
+        std::memcpy(&v, buf.data() + sizeof(Key), sizeof(Value));
+        AVLTree<Key, Value>::insert(std::make_pair(k, v));
+    }
+
+    uint32_t stored;
+    bool ok = std::fread(&stored, sizeof(stored), 1, f) == 1 && stored == sum;
+    std::fclose(f);
+    if(!ok) throw std::runtime_error("DurableAVLTree: checksum mismatch in " + checkpointName());
+
+    gen = header[1];
+    return true;
+}
+
+/**
+* Replays one log segment. Returns false if the segment does not exist. Replay of a
+* segment stops at the first record whose checksum does not match (a torn write).
+*/
+template<class Key, class Value>
+bool DurableAVLTree<Key, Value>::replaySegment(uint64_t gen)
+{
+    FILE* f = std::fopen(segmentName(gen).c_str(), "rb");
+    if(f == NULL) return false;
+
+    std::vector<char> buf(RECORD_SIZE * 4096);
+    size_t have = 0;
+    bool torn = false;
+    while(!torn)
+    {
+        size_t got = std::fread(buf.data() + have, 1, buf.size() - have, f);
+        have += got;
+        size_t off = 0;
+        for(; off + RECORD_SIZE <= have; off += RECORD_SIZE)
+        {
+            const char* rec = buf.data() + off;
+            uint32_t stored;
+            std::memcpy(&stored, rec + RECORD_SIZE - sizeof(uint32_t), sizeof(uint32_t));
+            if(stored != checksum(rec, RECORD_SIZE - sizeof(uint32_t)))
+            {
+                torn = true;
+                break;
+            }
+            Key k;
+            std::memcpy(&k, rec + 1, sizeof(Key));
+            if(rec[0] == LOG_INSERT)
+            {
+                Value v;
+                std::memcpy(&v, rec + 1 + sizeof(Key), sizeof(Value));
+                AVLTree<Key, Value>::insert(std::make_pair(k, v));
+            }
+            else if(rec[0] == LOG_REMOVE)
+            {
+                AVLTree<Key, Value>::remove(k);
+            }
+            else if(rec[0] == LOG_CLEAR)
+            {
+                AVLTree<Key, Value>::clear();
+            }
+            ++recovered_;
+        }
+        std::memmove(buf.data(), buf.data() + off, have - off);
+        have -= off;
+        if(got == 0) break;
+    }
+    std::fclose(f);
+    return true;
+}
+
+template<class Key, class Value>
+uint64_t DurableAVLTree<Key, Value>::recoveredOps() const
+{
+    return recovered_;
+}
+
+template<class Key, class Value>
+uint64_t DurableAVLTree<Key, Value>::syncCount() const
+{
+    std::lock_guard<std::mutex> lock(logMutex_);
+    return syncs_;
+}
+
+template<class Key, class Value>
+std::string DurableAVLTree<Key, Value>::segmentName(uint64_t gen) const
+{
+    return path_ + ".log." + std::to_string(gen);
+}
+
+template<class Key, class Value>
+std::string DurableAVLTree<Key, Value>::checkpointName() const
+{
+    return path_ + ".ckpt";
+}
+
+/**
+* FNV-1a, enough to spot torn or partially written records.
+*/
+template<class Key, class Value>
+uint32_t DurableAVLTree<Key, Value>::checksum(const char* data, size_t len)
+{
+    uint32_t h = 2166136261u;
+    for(size_t i = 0; i < len; ++i)
+    {
+        h ^= (unsigned char)data[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+template<class Key, class Value>
+void DurableAVLTree<Key, Value>::writeAll(int fd, const char* data, size_t len)
+{
+    while(len > 0)
+    {
+        ssize_t n = ::write(fd, data, len);
+        if(n < 0) throw std::runtime_error("DurableAVLTree: write failed");
+        data += n;
+        len -= (size_t)n;
+    }
+}
+
+/*
+  -----------------------------------------------
+  End implementations for the DurableAVLTree class.
+  -----------------------------------------------
+*/
+
+#endif
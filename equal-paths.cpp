@@ -8,26 +8,29 @@ using namespace std;
 
 
 // You may add any prototypes of helper functions here
-int height(Node *root);
+int leafDepth(Node *root);
 
 bool equalPaths(Node * root)
 {
 	// Add your code below
-	if(height(root)==0 || height(root)==1) return true;
-	if(height(root->left)==0) return equalPaths(root->right);
-	if(height(root->right)==0) return equalPaths(root->left);
-	if(height(root->left)!=height(root->right)) return false;
-	return equalPaths(root->left) && equalPaths(root->right);
+	return leafDepth(root) >= 0;
 }
 
 
-int height(Node *root) {
-	int res = 1;
+// Returns the depth shared by every leaf under root (0 for an empty tree), or -1 if
+// the leaves are at different depths. One visit per node, unlike calling a height
+// helper at every level.
+int leafDepth(Node *root) {
 	if(root==NULL) return 0;
 
-	res += height(root ->left);
-	int h = height(root ->right)+1;
-	if(h>res) res = h;
-	
-	return res;
+	int l = leafDepth(root->left);
+	if(l<0) return -1;
+	int r = leafDepth(root->right);
+	if(r<0) return -1;
+
+	// a missing child has no leaves to disagree with
+	if(l==0) return r+1;
+	if(r==0) return l+1;
+	if(l!=r) return -1;
+	return l+1;
 }
\ No newline at end of file
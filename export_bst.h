@@ -0,0 +1,247 @@
+#include <ostream>
+#include <random>
+#include <streambuf>
+#include <type_traits>
+#include <vector>
+#include <cstdint>
+
+#ifndef EXPORT_BST_H
+#define EXPORT_BST_H
+
+// BST export functions
+//
+// exportDot() writes a Graphviz digraph (render it with `dot -Tsvg`) and
+// exportJsonLines() writes one JSON object per node:
+//
+//   {"id":0,"key":4,"depth":3,"height":1,"balance":0,"left":null,"right":null}
+//
+// Nodes come out in post-order, so children always appear before their parent, and
+// ids count up from 0 in that order. Unlike printRoot() there is no depth limit:
+// the walk keeps one small frame per level, so even a degenerate million-node tree
+// streams in O(n) time and O(height) memory.
+//
+// A child left out by TreeExportOptions::maxDepth or sampleRate is shown as "pruned"
+// (a dashed "..." box in DOT). Its parent's height and, on a tree that does not store
+// balance factors, its balance are then unknown and written as null (or "?").
+
+// Escapes whatever is written through it for use inside a double-quoted JSON or
+// DOT string, passing the result straight on to target.
+class ExportEscapeBuf : public std::streambuf
+{
+public:
+    explicit ExportEscapeBuf(std::streambuf* target) : target_(target) { }
+
+protected:
+    virtual int_type overflow(int_type ch)
+    {
+        if(traits_type::eq_int_type(ch, traits_type::eof()))
+        {
+            return traits_type::not_eof(ch);
+        }
+
+        static const char HEX[] = "0123456789abcdef";
+        unsigned char c = (unsigned char)traits_type::to_char_type(ch);
+        if(c == '"' || c == '\\')
+        {
+            target_->sputc('\\');
+            target_->sputc((char)c);
+        }
+        else if(c < 0x20)
+        {
+            target_->sputn("\\u00", 4);
+            target_->sputc(HEX[c >> 4]);
+            target_->sputc(HEX[c & 0xf]);
+        }
+        else
+        {
+            target_->sputc((char)c);
+        }
+        return ch;
+    }
+
+private:
+    std::streambuf* target_;
+};
+
+// Writes a key. Numbers go out bare (chars as their code, like the other integers);
+// anything else is escaped, and put in quotes when quote is set.
+template<typename T>
+void exportKey(std::ostream& out, const T& key, bool, std::true_type)
+{
+    out << +key;
+}
+
+template<typename T>
+void exportKey(std::ostream& out, const T& key, bool quote, std::false_type)
+{
+    if(quote) out << '"';
+    ExportEscapeBuf escaper(out.rdbuf());
+    std::ostream escaped(&escaper);
+    escaped << key;
+    if(quote) out << '"';
+}
+
+template<typename T>
+void exportKey(std::ostream& out, const T& key, bool quote)
+{
+    exportKey(out, key, quote, typename std::is_arithmetic<T>::type());
+}
+
+/**
+* Plain BSTs keep no balance factor; exportTree() works it out from the subtree heights.
+*/
+template<typename Key, typename Value>
+bool BinarySearchTree<Key, Value>::nodeBalance(const Node<Key, Value>*, int&) const
+{
+    return false;
+}
+
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::exportDot(std::ostream& out, const TreeExportOptions& options) const
+{
+    exportTree(out, options, true);
+}
+
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::exportJsonLines(std::ostream& out, const TreeExportOptions& options) const
+{
+    exportTree(out, options, false);
+}
+
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::exportTree(std::ostream& out, const TreeExportOptions& options, bool dot) const
+{
+    // what became of one child of a frame's node
+    enum ChildState { CHILD_NONE, CHILD_EXPORTED, CHILD_PRUNED };
+
+    // a node on the path from the root to the node being visited
+    struct Frame
+    {
+        const Node<Key, Value>* node;
+        int depth;
+        // children handled so far: 0, 1 (left) or 2 (both)
+        int visited;
+        ChildState child[2];
+        uint64_t childId[2];
+        // subtree height of each child, or -1 if part of it was pruned
+        int childHeight[2];
+    };
+
+    std::mt19937_64 rng(options.seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::vector<Frame> path;
+    uint64_t nextId = 0;
+
+    if(dot)
+    {
+        out << "digraph BST {\n    graph [ordering=out];\n    node [shape=box];\n";
+    }
+
+    if(root_ != nullptr)
+    {
+        Frame root = { root_, 1, 0, {CHILD_NONE, CHILD_NONE}, {0, 0}, {0, 0} };
+        path.push_back(root);
+    }
+
+    while(!path.empty())
+    {
+        Frame& top = path.back();
+        if(top.visited < 2)
+        {
+            int side = top.visited++;
+            const Node<Key, Value>* child = side == 0 ? top.node->getLeft() : top.node->getRight();
+            if(child == nullptr)
+            {
+                top.child[side] = CHILD_NONE;
+                top.childHeight[side] = 0;
+            }
+            else if((options.maxDepth > 0 && top.depth >= options.maxDepth) ||
+                (options.sampleRate < 1.0 && coin(rng) >= options.sampleRate))
+            {
+                top.child[side] = CHILD_PRUNED;
+                top.childHeight[side] = -1;
+            }
+            else
+            {
+                top.child[side] = CHILD_EXPORTED;
+                Frame next = { child, top.depth + 1, 0, {CHILD_NONE, CHILD_NONE}, {0, 0}, {0, 0} };
+                // top is invalidated by the push
+                path.push_back(next);
+            }
+            continue;
+        }
+
+        // both subtrees are done, so the node itself can go out
+        uint64_t id = nextId++;
+        int height = -1;
+        if(top.childHeight[0] >= 0 && top.childHeight[1] >= 0)
+        {
+            height = 1 + (top.childHeight[0] > top.childHeight[1] ? top.childHeight[0] : top.childHeight[1]);
+        }
+        int balance = 0;
+        bool knowBalance = nodeBalance(top.node, balance);
+        if(!knowBalance && top.childHeight[0] >= 0 && top.childHeight[1] >= 0)
+        {
+            balance = top.childHeight[1] - top.childHeight[0];
+            knowBalance = true;
+        }
+
+        if(dot)
+        {
+            out << "    n" << id << " [label=\"";
+            exportKey(out, top.node->getKey(), false);
+            out << "\\nb=";
+            if(knowBalance) out << balance;
+            else out << '?';
+            out << "\"];\n";
+            for(int side = 0; side < 2; ++side)
+            {
+                const char* name = side == 0 ? "L" : "R";
+                if(top.child[side] == CHILD_EXPORTED)
+                {
+                    out << "    n" << id << " -> n" << top.childId[side] << " [label=" << name << "];\n";
+                }
+                else if(top.child[side] == CHILD_PRUNED)
+                {
+                    out << "    p" << id << name << " [label=\"...\", style=dashed];\n";
+                    out << "    n" << id << " -> p" << id << name << " [label=" << name << ", style=dashed];\n";
+                }
+            }
+        }
+        else
+        {
+            out << "{\"id\":" << id << ",\"key\":";
+            exportKey(out, top.node->getKey(), true);
+            out << ",\"depth\":" << top.depth << ",\"height\":";
+            if(height >= 0) out << height;
+            else out << "null";
+            out << ",\"balance\":";
+            if(knowBalance) out << balance;
+            else out << "null";
+            for(int side = 0; side < 2; ++side)
+            {
+                out << (side == 0 ? ",\"left\":" : ",\"right\":");
+                if(top.child[side] == CHILD_EXPORTED) out << top.childId[side];
+                else if(top.child[side] == CHILD_PRUNED) out << "\"pruned\"";
+                else out << "null";
+            }
+            out << "}\n";
+        }
+
+        path.pop_back();
+        if(!path.empty())
+        {
+            // the side just finished is the last one the parent visited
+            Frame& parent = path.back();
+            parent.childId[parent.visited - 1] = id;
+            parent.childHeight[parent.visited - 1] = height;
+        }
+    }
+
+    if(dot)
+    {
+        out << "}\n";
+    }
+}
+
+#endif
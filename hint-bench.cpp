@@ -0,0 +1,69 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
+#include "bench_utils.h"
+#include "avlbst.h"
+
+using namespace std;
+
+// AVLTree::insert() against insert(hint, pair) for keys that arrive in or nearly in
+// order.
+//
+// usage: hint-bench [entries]
+//
+// Ascending keys go past the maximum every time. Nearly sorted keys are 0..entries-1
+// shuffled within consecutive windows of 64, as timestamps from several sources are.
+// The hints are end() and the iterator the previous hinted insert returned.
+
+static const size_t WINDOW = 64;
+
+enum Mode { PLAIN, HINT_END, HINT_PREVIOUS };
+
+static double run(const vector<int>& keys, Mode mode)
+{
+	AVLTree<int, int> tree;
+	AVLTree<int, int>::iterator last = tree.end();
+	Stopwatch watch;
+	for(size_t i = 0; i < keys.size(); i++)
+	{
+		if(mode == PLAIN) tree.insert(make_pair(keys[i], (int)i));
+		else if(mode == HINT_END) tree.insert(tree.end(), make_pair(keys[i], (int)i));
+		else last = tree.insert(last, make_pair(keys[i], (int)i));
+	}
+	double secs = watch.seconds();
+	if(!tree.isBalanced()) cerr << "not balanced" << endl;
+	return keys.size() / secs;
+}
+
+static void report(const char* name, const vector<int>& keys)
+{
+	double plain = run(keys, PLAIN);
+	double hintEnd = run(keys, HINT_END);
+	double hintPrevious = run(keys, HINT_PREVIOUS);
+	cout << name << endl;
+	cout << "  insert() keys/s:                 " << (uint64_t)plain << endl;
+	cout << "  insert(end(), ...) keys/s:       " << (uint64_t)hintEnd << " (" << hintEnd / plain << "x)" << endl;
+	cout << "  insert(previous, ...) keys/s:    " << (uint64_t)hintPrevious << " (" << hintPrevious / plain << "x)" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 4000000;
+	if(n == 0)
+	{
+		cerr << "usage: " << argv[0] << " [entries > 0]" << endl;
+		return 1;
+	}
+
+	vector<int> keys(n);
+	for(size_t i = 0; i < n; i++) keys[i] = (int)i;
+	report("ascending keys", keys);
+
+	mt19937 rng(44);
+	for(size_t i = 0; i < n; i += WINDOW)
+		shuffle(keys.begin() + i, keys.begin() + min(n, i + WINDOW), rng);
+	report("nearly sorted keys", keys);
+	return 0;
+}
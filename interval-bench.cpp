@@ -0,0 +1,79 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
+#include "bench_utils.h"
+#include "interval_tree.h"
+
+using namespace std;
+
+// IntervalTree overlap queries against scanning every interval with the iterator,
+// which is how reservations were searched before.
+//
+// usage: interval-bench [intervals] [queries]
+//
+// Reservations start uniformly over a day in milliseconds and last up to two minutes;
+// queries ask for one-minute windows. The scan runs a tenth of the queries, since each
+// one reads the whole tree.
+
+static const uint64_t DAY_MS = 86400000;
+static const uint64_t MAX_LENGTH_MS = 120000;
+static const uint64_t WINDOW_MS = 60000;
+
+int main(int argc, char *argv[])
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+	size_t queries = argc > 2 ? strtoul(argv[2], NULL, 10) : 1000;
+	if(queries < 10)
+	{
+		cerr << "usage: " << argv[0] << " [intervals] [queries >= 10]" << endl;
+		return 1;
+	}
+
+	mt19937_64 rng(40);
+	IntervalTree<uint64_t, uint32_t> tree;
+	Stopwatch watch;
+	for(size_t i = 0; i < n; i++)
+	{
+		uint64_t start = rng() % DAY_MS;
+		tree.insert(start, start + rng() % MAX_LENGTH_MS, (uint32_t)i);
+	}
+	double buildSecs = watch.seconds();
+
+	vector<uint64_t> windows(queries);
+	for(size_t i = 0; i < queries; i++) windows[i] = rng() % DAY_MS;
+
+	watch.restart();
+	size_t found = 0;
+	for(size_t i = 0; i < queries; i++)
+		found += tree.overlaps(windows[i], windows[i] + WINDOW_MS).size();
+	double treeSecs = watch.seconds();
+
+	watch.restart();
+	size_t any = 0;
+	for(size_t i = 0; i < queries; i++)
+		if(tree.anyOverlap(windows[i], windows[i] + WINDOW_MS)) any++;
+	double anySecs = watch.seconds();
+
+	size_t scanQueries = queries / 10;
+	watch.restart();
+	size_t scanned = 0;
+	for(size_t i = 0; i < scanQueries; i++)
+	{
+		uint64_t lo = windows[i], hi = windows[i] + WINDOW_MS;
+		for(IntervalTree<uint64_t, uint32_t>::iterator it = tree.begin(); it != tree.end(); ++it)
+			if(it->first.start <= hi && lo <= it->first.end) scanned++;
+	}
+	double scanSecs = watch.seconds();
+
+	cout << "intervals:              " << n << endl;
+	cout << "build/s:                " << (uint64_t)(n / buildSecs) << endl;
+	cout << "height:                 " << tree.profile().height << endl;
+	cout << "results per query:      " << (double)found / queries << endl;
+	cout << "overlaps() queries/s:   " << (uint64_t)(queries / treeSecs) << endl;
+	cout << "anyOverlap() queries/s: " << (uint64_t)(queries / anySecs) << " (" << any << " hits)" << endl;
+	cout << "scan queries/s:         " << scanQueries / scanSecs << " (" << (double)scanned / scanQueries << " results per query)" << endl;
+	cout << "speedup over scan:      " << (scanSecs / scanQueries) / (treeSecs / queries) << "x" << endl;
+	return 0;
+}
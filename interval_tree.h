@@ -0,0 +1,242 @@
+#ifndef INTERVAL_TREE_H
+#define INTERVAL_TREE_H
+
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include "avlbst.h"
+
+/**
+* A closed interval [start, end], the key of an IntervalTree. Intervals are ordered by
+* start and then by end.
+*/
+template <typename Point>
+struct Interval
+{
+    Interval(const Point& start, const Point& end) : start(start), end(end) { }
+
+    Point start;
+    Point end;
+};
+
+template<typename Point>
+bool operator<(const Interval<Point>& a, const Interval<Point>& b)
+{
+    return a.start < b.start || (!(b.start < a.start) && a.end < b.end);
+}
+
+template<typename Point>
+bool operator>(const Interval<Point>& a, const Interval<Point>& b)
+{
+    return b < a;
+}
+
+template<typename Point>
+bool operator==(const Interval<Point>& a, const Interval<Point>& b)
+{
+    return !(a < b) && !(b < a);
+}
+
+template<typename Point>
+bool operator!=(const Interval<Point>& a, const Interval<Point>& b)
+{
+    return !(a == b);
+}
+
+template<typename Point>
+std::ostream& operator<<(std::ostream& out, const Interval<Point>& interval)
+{
+    return out << "[" << interval.start << ", " << interval.end << "]";
+}
+
+/**
+* An AVLNode keyed by an interval that also holds the largest end
+* point in its subtree.
+*/
+template <typename Point, typename Value>
+class IntervalNode : public AVLNode<Interval<Point>, Value>
+{
+public:
+    IntervalNode(const Interval<Point>& key, const Value& value, AVLNode<Interval<Point>, Value>* parent);
+
+    const Point& getMaxEnd() const;
+    void setMaxEnd(const Point& maxEnd);
+
+protected:
+    Point maxEnd_;
+};
+
+template<class Point, class Value>
+IntervalNode<Point, Value>::IntervalNode(const Interval<Point>& key, const Value& value, AVLNode<Interval<Point>, Value>* parent) :
+    AVLNode<Interval<Point>, Value>(key, value, parent), maxEnd_(key.end)
+{
+
+}
+
+template<class Point, class Value>
+const Point& IntervalNode<Point, Value>::getMaxEnd() const
+{
+    return maxEnd_;
+}
+
+template<class Point, class Value>
+void IntervalNode<Point, Value>::setMaxEnd(const Point& maxEnd)
+{
+    maxEnd_ = maxEnd;
+}
+
+/**
+* An AVLTree keyed by closed intervals, so several intervals can share a start. Every
+* node keeps the largest end point in its subtree, maintained through AVLTree's
+* augmentation hooks (see augmented_avl.h), which lets overlap queries skip every
+* subtree that ends before the query begins.
+*
+* anyOverlap() takes O(log n). overlaps() visits only the subtrees that hold a result,
+* plus one root path: O(log n + k) when the results are adjacent in key order, as they
+* are when no interval lies inside another, and O((k + 1) log n) at worst.
+*/
+template <typename Point, typename Value>
+class IntervalTree : public AVLTree<Interval<Point>, Value>
+{
+public:
+    typedef typename AVLTree<Interval<Point>, Value>::iterator iterator;
+
+    using AVLTree<Interval<Point>, Value>::insert;
+    using AVLTree<Interval<Point>, Value>::remove;
+    // throws std::invalid_argument if end < start
+    void insert(const Point& start, const Point& end, const Value& value);
+    void remove(const Point& start, const Point& end);
+
+    // every interval that shares a point with [lo, hi], in key order
+    std::vector<iterator> overlaps(const Point& lo, const Point& hi) const;
+    bool anyOverlap(const Point& lo, const Point& hi) const;
+
+protected:
+    typedef IntervalNode<Point, Value> INode;
+
+    virtual AVLNode<Interval<Point>, Value>* makeNode(const Interval<Point>& key, const Value& value, AVLNode<Interval<Point>, Value>* parent) override;
+    virtual void pullUp(AVLNode<Interval<Point>, Value>* n) override;
+    virtual void pullUpPath(AVLNode<Interval<Point>, Value>* n) override;
+    virtual void nodeSwap(AVLNode<Interval<Point>, Value>* n1, AVLNode<Interval<Point>, Value>* n2) override;
+
+    void collectOverlaps(INode* n, const Point& lo, const Point& hi, std::vector<iterator>& out) const;
+    static INode* asINode(Node<Interval<Point>, Value>* n);
+};
+
+/*
+  ---------------------------------------------------
+  Begin implementations for the IntervalTree class.
+  ---------------------------------------------------
+*/
+
+template<class Point, class Value>
+void IntervalTree<Point, Value>::insert(const Point& start, const Point& end, const Value& value)
+{
+    if(end < start) throw std::invalid_argument("Interval ends before it starts");
+    insert(std::make_pair(Interval<Point>(start, end), value));
+}
+
+template<class Point, class Value>
+void IntervalTree<Point, Value>::remove(const Point& start, const Point& end)
+{
+    remove(Interval<Point>(start, end));
+}
+
+template<class Point, class Value>
+std::vector<typename IntervalTree<Point, Value>::iterator>
+IntervalTree<Point, Value>::overlaps(const Point& lo, const Point& hi) const
+{
+    std::vector<iterator> out;
+    collectOverlaps(asINode(this->root_), lo, hi, out);
+    return out;
+}
+
+/**
+* Walks down towards the side that must hold an overlap if any does: the left
+* subtree whenever it reaches lo, since its interval with the largest end then either
+* overlaps or starts after hi, and so does everything on the right.
+*/
+template<class Point, class Value>
+bool IntervalTree<Point, Value>::anyOverlap(const Point& lo, const Point& hi) const
+{
+    INode* n = asINode(this->root_);
+    while(n != NULL)
+    {
+        const Interval<Point>& interval = n->getKey();
+        if(!(hi < interval.start) && !(interval.end < lo)) return true;
+        INode* left = asINode(n->getLeft());
+        if(left != NULL && !(left->getMaxEnd() < lo)) n = left;
+        else if(hi < interval.start) return false;
+        else n = asINode(n->getRight());
+    }
+    return false;
+}
+
+/**
+* In-order walk that skips subtrees ending before lo and stops at the first start
+* past hi. Recursion is bounded by the tree's height.
+*/
+template<class Point, class Value>
+void IntervalTree<Point, Value>::collectOverlaps(INode* n, const Point& lo, const Point& hi, std::vector<iterator>& out) const
+{
+    if(n == NULL || n->getMaxEnd() < lo) return;
+    collectOverlaps(asINode(n->getLeft()), lo, hi, out);
+    if(hi < n->getKey().start) return;
+    if(!(n->getKey().end < lo)) out.push_back(this->iteratorAt(n));
+    collectOverlaps(asINode(n->getRight()), lo, hi, out);
+}
+
+template<class Point, class Value>
+AVLNode<Interval<Point>, Value>* IntervalTree<Point, Value>::makeNode(const Interval<Point>& key, const Value& value, AVLNode<Interval<Point>, Value>* parent)
+{
+    return new INode(key, value, parent);
+}
+
+template<class Point, class Value>
+void IntervalTree<Point, Value>::pullUp(AVLNode<Interval<Point>, Value>* n)
+{
+    INode* node = asINode(n);
+    Point maxEnd = node->getKey().end;
+    INode* left = asINode(node->getLeft());
+    INode* right = asINode(node->getRight());
+    if(left != NULL && maxEnd < left->getMaxEnd()) maxEnd = left->getMaxEnd();
+    if(right != NULL && maxEnd < right->getMaxEnd()) maxEnd = right->getMaxEnd();
+    node->setMaxEnd(maxEnd);
+}
+
+template<class Point, class Value>
+void IntervalTree<Point, Value>::pullUpPath(AVLNode<Interval<Point>, Value>* n)
+{
+    for(; n != NULL; n = n->getParent())
+        pullUp(n);
+}
+
+/**
+* As in AugmentedAVLTree, the maximum stays with the upper position and remove()
+* recomputes the path from the lower one.
+*/
+template<class Point, class Value>
+void IntervalTree<Point, Value>::nodeSwap(AVLNode<Interval<Point>, Value>* n1, AVLNode<Interval<Point>, Value>* n2)
+{
+    AVLTree<Interval<Point>, Value>::nodeSwap(n1, n2);
+    Point temp = asINode(n1)->getMaxEnd();
+    asINode(n1)->setMaxEnd(asINode(n2)->getMaxEnd());
+    asINode(n2)->setMaxEnd(temp);
+}
+
+template<class Point, class Value>
+IntervalNode<Point, Value>* IntervalTree<Point, Value>::asINode(Node<Interval<Point>, Value>* n)
+{
+    return static_cast<INode*>(n);
+}
+
+/*
+  ---------------------------------------------------
+  End implementations for the IntervalTree class.
+  ---------------------------------------------------
+*/
+
+#endif
@@ -0,0 +1,119 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <cstdlib>
+#include "bench_utils.h"
+#include "avlbst.h"
+
+using namespace std;
+
+// AVLTree::parallelReduce() against a full scan with the iterator, at several thread
+// counts.
+//
+// usage: parallel-bench [entries]
+//
+// The tree is built from random keys, so its nodes are scattered over the heap as a
+// long-lived tree's are. The unordered reduction sums the values; the ordered one
+// computes a polynomial hash of the keys in key order, which only comes out right if
+// the pieces are combined left to right. Both are checked against the iterator.
+
+static const unsigned THREADS[] = { 1, 2, 4, 8, 16 };
+static const int ROUNDS = 5;
+
+static const uint64_t HASH_BASE = 1000003;
+
+struct SumValues
+{
+	void operator()(uint64_t& sum, pair<const int, int>& entry) const { sum += (uint64_t)entry.second; }
+};
+
+struct AddSums
+{
+	void operator()(uint64_t& into, const uint64_t& from) const { into += from; }
+};
+
+// hash of a run of keys, and HASH_BASE to the power of its length
+struct KeyHash
+{
+	uint64_t hash;
+	uint64_t scale;
+};
+
+struct HashKeys
+{
+	void operator()(KeyHash& h, pair<const int, int>& entry) const
+	{
+		h.hash = h.hash * HASH_BASE + (uint64_t)entry.first;
+		h.scale *= HASH_BASE;
+	}
+};
+
+struct AppendHash
+{
+	void operator()(KeyHash& into, const KeyHash& from) const
+	{
+		into.hash = into.hash * from.scale + from.hash;
+		into.scale *= from.scale;
+	}
+};
+
+int main(int argc, char *argv[])
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 4000000;
+	if(n == 0)
+	{
+		cerr << "usage: " << argv[0] << " [entries > 0]" << endl;
+		return 1;
+	}
+
+	mt19937 rng(48);
+	vector<int> keys(n);
+	for(size_t i = 0; i < n; i++) keys[i] = (int)i;
+	shuffle(keys.begin(), keys.end(), rng);
+	AVLTree<int, int> tree;
+	for(size_t i = 0; i < n; i++) tree.insert(make_pair(keys[i], (int)(rng() % 1000)));
+
+	cout << "AVLTree<int,int> with " << n << " entries, " << thread::hardware_concurrency() << " hardware threads" << endl;
+
+	Stopwatch watch;
+	uint64_t sum = 0;
+	KeyHash hash = { 0, 1 };
+	for(int r = 0; r < ROUNDS; r++)
+	{
+		sum = 0;
+		hash.hash = 0;
+		hash.scale = 1;
+		for(AVLTree<int, int>::iterator it = tree.begin(); it != tree.end(); ++it)
+		{
+			sum += (uint64_t)it->second;
+			HashKeys()(hash, *it);
+		}
+	}
+	double iterSecs = watch.seconds() / ROUNDS;
+	cout << "  iterator scan:         " << (uint64_t)(n / iterSecs) << " entries/s" << endl;
+
+	for(size_t t = 0; t < sizeof(THREADS) / sizeof(THREADS[0]); t++)
+	{
+		KeyHash empty = { 0, 1 };
+		uint64_t parallelSum = 0;
+		KeyHash parallelHash = empty;
+
+		watch.restart();
+		for(int r = 0; r < ROUNDS; r++)
+			parallelSum = tree.parallelReduce((uint64_t)0, SumValues(), AddSums(), THREADS[t]);
+		double sumSecs = watch.seconds() / ROUNDS;
+
+		watch.restart();
+		for(int r = 0; r < ROUNDS; r++)
+			parallelHash = tree.parallelReduce(empty, HashKeys(), AppendHash(), THREADS[t], true);
+		double hashSecs = watch.seconds() / ROUNDS;
+
+		if(parallelSum != sum || parallelHash.hash != hash.hash) cerr << "mismatch at " << THREADS[t] << " threads" << endl;
+		cout << "  " << THREADS[t] << " threads" << endl;
+		cout << "    sum (unordered):     " << (uint64_t)(n / sumSecs) << " entries/s (" << iterSecs / sumSecs << "x)" << endl;
+		cout << "    key hash (ordered):  " << (uint64_t)(n / hashSecs) << " entries/s (" << iterSecs / hashSecs << "x)" << endl;
+	}
+	return 0;
+}
@@ -0,0 +1,388 @@
+#ifndef PARALLEL_BST_H
+#define PARALLEL_BST_H
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// BST parallel scans
+//
+// parallelForEach() and parallelReduce() cut the tree near the root into pieces: whole
+// subtrees, plus the single nodes above them that were split off, kept in key order.
+// Cutting stops once there are about 8 subtrees per thread, so on a balanced tree the
+// pieces are of similar size and a thread that draws a large one is evened out by the
+// others stealing from it. A degenerate BinarySearchTree has one big subtree at every
+// level, so it stays one piece and runs on one thread.
+//
+// Each piece is walked in order through the parent pointers, without recursion and
+// without the iterator's per-step checks. Scans are not traced, and with BST_STATS on
+// the workers' counters are their own (see bst_stats.h), not the caller's.
+//
+// The same pool runs parallelStableSort(), the sort behind AVLTree::buildParallel().
+
+/**
+* Runs a fixed set of tasks on a few threads. Each worker starts with a contiguous run
+* of the tasks in its own deque and takes them from the front; once that is empty it
+* steals from the back of the others' deques, the end their owners would reach last.
+* The calling thread is worker 0.
+*
+* If a task throws, no new tasks are started and run() rethrows the first exception
+* once the threads have stopped.
+*/
+class WorkStealingPool
+{
+public:
+    // 0 threads means one per hardware thread
+    explicit WorkStealingPool(unsigned threads) :
+        threads_(threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency())),
+        failed_(false)
+    {
+
+    }
+
+    unsigned threads() const { return threads_; }
+
+    // calls task(i, worker) once for every i in [0, count), worker being the index of
+    // the thread that runs it
+    template<typename Task>
+    void run(size_t count, Task& task);
+
+private:
+    struct Queue
+    {
+        std::mutex lock;
+        std::deque<size_t> tasks;
+    };
+
+    bool take(std::vector<Queue>& queues, unsigned worker, size_t& index);
+
+    template<typename Task>
+    void work(std::vector<Queue>& queues, unsigned worker, Task& task);
+
+    unsigned threads_;
+    std::atomic<bool> failed_;
+    std::mutex errorLock_;
+    std::exception_ptr error_;
+};
+
+template<typename Task>
+void WorkStealingPool::run(size_t count, Task& task)
+{
+    unsigned workers = (unsigned)std::min<size_t>(threads_, count);
+    if(workers <= 1)
+    {
+        for(size_t i = 0; i < count; i++) task(i, 0u);
+        return;
+    }
+
+    std::vector<Queue> queues(workers);
+    for(unsigned w = 0; w < workers; w++)
+    {
+        for(size_t i = count * w / workers; i < count * (w + 1) / workers; i++)
+            queues[w].tasks.push_back(i);
+    }
+    failed_ = false;
+    error_ = std::exception_ptr();
+
+    std::vector<std::thread> helpers;
+    for(unsigned w = 1; w < workers; w++)
+        helpers.push_back(std::thread(&WorkStealingPool::work<Task>, this, std::ref(queues), w, std::ref(task)));
+    work(queues, 0, task);
+    for(size_t i = 0; i < helpers.size(); i++) helpers[i].join();
+
+    if(error_) std::rethrow_exception(error_);
+}
+
+inline bool WorkStealingPool::take(std::vector<Queue>& queues, unsigned worker, size_t& index)
+{
+    {
+        std::lock_guard<std::mutex> guard(queues[worker].lock);
+        if(!queues[worker].tasks.empty())
+        {
+            // the front of our own run, so each worker walks its pieces in key order
+            index = queues[worker].tasks.front();
+            queues[worker].tasks.pop_front();
+            return true;
+        }
+    }
+    for(size_t k = 1; k < queues.size(); k++)
+    {
+        Queue& victim = queues[(worker + k) % queues.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if(!victim.tasks.empty())
+        {
+            index = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+template<typename Task>
+void WorkStealingPool::work(std::vector<Queue>& queues, unsigned worker, Task& task)
+{
+    size_t index;
+    while(!failed_ && take(queues, worker, index))
+    {
+        try
+        {
+            task(index, worker);
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> guard(errorLock_);
+            if(!error_) error_ = std::current_exception();
+            failed_ = true;
+        }
+    }
+}
+
+// Stable-sorts one run of the array for parallelStableSort().
+template<typename T, typename Less>
+struct SortRunTask
+{
+    std::vector<T>* items;
+    const std::vector<size_t>* bounds;
+    Less less;
+
+    void operator()(size_t i, unsigned)
+    {
+        std::stable_sort(items->begin() + (*bounds)[i], items->begin() + (*bounds)[i + 1], less);
+    }
+};
+
+// Merges runs 2i and 2i + 1 (or moves run 2i, if it is the last) from one array into
+// the same place in the other, for parallelStableSort().
+template<typename T, typename Less>
+struct MergeRunsTask
+{
+    std::vector<T>* from;
+    std::vector<T>* to;
+    const std::vector<size_t>* bounds;
+    Less less;
+
+    void operator()(size_t i, unsigned)
+    {
+        const std::vector<size_t>& b = *bounds;
+        size_t lo = b[2 * i], mid = b[std::min(2 * i + 1, b.size() - 1)], hi = b[std::min(2 * i + 2, b.size() - 1)];
+        std::merge(std::make_move_iterator(from->begin() + lo), std::make_move_iterator(from->begin() + mid),
+            std::make_move_iterator(from->begin() + mid), std::make_move_iterator(from->begin() + hi),
+            to->begin() + lo, less);
+    }
+};
+
+/**
+* Sorts items like std::stable_sort, on pool's threads: one run per thread is sorted
+* in parallel, then pairs of neighbouring runs are merged in parallel rounds, the left
+* run winning ties. The last round is a single merge on one thread. T must be
+* default-constructible, for the merge buffer.
+*/
+template<typename T, typename Less>
+void parallelStableSort(std::vector<T>& items, Less less, WorkStealingPool& pool)
+{
+    size_t runs = std::min<size_t>(pool.threads(), items.size() / 4096);
+    if(runs <= 1)
+    {
+        std::stable_sort(items.begin(), items.end(), less);
+        return;
+    }
+
+    std::vector<size_t> bounds(runs + 1);
+    for(size_t i = 0; i <= runs; i++) bounds[i] = items.size() * i / runs;
+    SortRunTask<T, Less> sortTask = { &items, &bounds, less };
+    pool.run(runs, sortTask);
+
+    std::vector<T> buffer(items.size());
+    std::vector<T>* from = &items;
+    std::vector<T>* to = &buffer;
+    while(bounds.size() > 2)
+    {
+        MergeRunsTask<T, Less> mergeTask = { from, to, &bounds, less };
+        pool.run(bounds.size() / 2, mergeTask);
+        std::vector<size_t> merged;
+        for(size_t i = 0; i < bounds.size(); i += 2) merged.push_back(bounds[i]);
+        if(merged.back() != items.size()) merged.push_back(items.size());
+        bounds.swap(merged);
+        std::swap(from, to);
+    }
+    if(from != &items) items.swap(buffer);
+}
+
+// One piece of a cut tree: the subtree under node, or just node itself.
+template<typename Key, typename Value>
+struct ParallelPiece
+{
+    Node<Key, Value>* node;
+    bool wholeSubtree;
+};
+
+// Applies fn to every node of a piece in key order.
+template<typename Key, typename Value, typename Fn>
+void parallelWalk(const ParallelPiece<Key, Value>& piece, Fn& fn)
+{
+    Node<Key, Value>* top = piece.node;
+    if(!piece.wholeSubtree)
+    {
+        fn(top->getItem());
+        return;
+    }
+    Node<Key, Value>* n = top;
+    while(n->getLeft() != NULL) n = n->getLeft();
+    while(true)
+    {
+        fn(n->getItem());
+        if(n->getRight() != NULL)
+        {
+            n = n->getRight();
+            while(n->getLeft() != NULL) n = n->getLeft();
+            continue;
+        }
+        // up past every subtree we have finished, stopping at the top of the piece
+        while(n != top && n == n->getParent()->getRight()) n = n->getParent();
+        if(n == top) return;
+        n = n->getParent();
+    }
+}
+
+// The task for parallelForEach(): walks piece i with the shared fn.
+template<typename Key, typename Value, typename Fn>
+struct ParallelForEachTask
+{
+    const std::vector<ParallelPiece<Key, Value> >* pieces;
+    Fn* fn;
+
+    void operator()(size_t i, unsigned) { parallelWalk((*pieces)[i], *fn); }
+};
+
+// Folds entries into one accumulator.
+template<typename Key, typename Value, typename T, typename Fold>
+struct ParallelFolder
+{
+    T* acc;
+    Fold* fold;
+
+    void operator()(std::pair<const Key, Value>& entry) { (*fold)(*acc, entry); }
+};
+
+// The task for parallelReduce(): folds piece i into a copy of identity of its own,
+// then moves that into the piece's slot when the reduction is ordered, or combines it
+// into the worker's slot when it is not. The slots sit next to each other in one
+// array, so the workers write them once per piece instead of once per entry, and do
+// not keep taking each other's cache lines away.
+template<typename Key, typename Value, typename T, typename Fold, typename Combine>
+struct ParallelReduceTask
+{
+    const std::vector<ParallelPiece<Key, Value> >* pieces;
+    std::vector<T>* partials;
+    const T* identity;
+    Fold fold;
+    Combine combine;
+    bool ordered;
+
+    void operator()(size_t i, unsigned worker)
+    {
+        T acc = *identity;
+        ParallelFolder<Key, Value, T, Fold> folder = { &acc, &fold };
+        parallelWalk((*pieces)[i], folder);
+        if(ordered) (*partials)[i] = std::move(acc);
+        else combine((*partials)[worker], acc);
+    }
+};
+
+/**
+* Splits every whole subtree in the list into its left subtree, its root and its right
+* subtree, one level at a time, until there are enough subtrees to go round or a few
+* levels more than a perfectly balanced tree would need.
+*/
+template<typename Key, typename Value>
+void BinarySearchTree<Key, Value>::cutForParallel(unsigned threads, std::vector<ParallelPiece<Key, Value> >& pieces) const
+{
+    pieces.clear();
+    if(root_ == NULL) return;
+    ParallelPiece<Key, Value> whole = { root_, true };
+    pieces.push_back(whole);
+
+    size_t wanted = 8 * (size_t)threads;
+    int maxLevels = 4;
+    for(size_t w = wanted; w > 1; w /= 2) maxLevels++;
+
+    size_t subtrees = 1;
+    std::vector<ParallelPiece<Key, Value> > next;
+    for(int level = 0; level < maxLevels && subtrees < wanted; level++)
+    {
+        next.clear();
+        size_t nextSubtrees = 0;
+        bool split = false;
+        for(size_t i = 0; i < pieces.size(); i++)
+        {
+            Node<Key, Value>* n = pieces[i].node;
+            if(!pieces[i].wholeSubtree || (n->getLeft() == NULL && n->getRight() == NULL))
+            {
+                next.push_back(pieces[i]);
+                nextSubtrees += pieces[i].wholeSubtree;
+                continue;
+            }
+            if(n->getLeft() != NULL)
+            {
+                ParallelPiece<Key, Value> left = { n->getLeft(), true };
+                next.push_back(left);
+                nextSubtrees++;
+            }
+            split = true;
+            ParallelPiece<Key, Value> self = { n, false };
+            next.push_back(self);
+            if(n->getRight() != NULL)
+            {
+                ParallelPiece<Key, Value> right = { n->getRight(), true };
+                next.push_back(right);
+                nextSubtrees++;
+            }
+        }
+        pieces.swap(next);
+        subtrees = nextSubtrees;
+        // every subtree left is a single leaf
+        if(!split) break;
+    }
+}
+
+template<typename Key, typename Value>
+template<typename Fn>
+void BinarySearchTree<Key, Value>::parallelForEach(Fn fn, unsigned threads) const
+{
+    WorkStealingPool pool(threads);
+    std::vector<ParallelPiece<Key, Value> > pieces;
+    cutForParallel(pool.threads(), pieces);
+
+    ParallelForEachTask<Key, Value, Fn> task = { &pieces, &fn };
+    pool.run(pieces.size(), task);
+}
+
+/**
+* The partial results are combined on the calling thread: left to right, one per
+* piece, when ordered; otherwise one per worker in worker order, each of those having
+* taken in its pieces' results in the order the worker ran them.
+*/
+template<typename Key, typename Value>
+template<typename T, typename Fold, typename Combine>
+T BinarySearchTree<Key, Value>::parallelReduce(const T& identity, Fold fold, Combine combine, unsigned threads, bool ordered) const
+{
+    WorkStealingPool pool(threads);
+    std::vector<ParallelPiece<Key, Value> > pieces;
+    cutForParallel(pool.threads(), pieces);
+
+    std::vector<T> partials(ordered ? pieces.size() : pool.threads(), identity);
+    ParallelReduceTask<Key, Value, T, Fold, Combine> task = { &pieces, &partials, &identity, fold, combine, ordered };
+    pool.run(pieces.size(), task);
+
+    T result = identity;
+    for(size_t i = 0; i < partials.size(); i++) combine(result, partials[i]);
+    return result;
+}
+
+#endif
@@ -0,0 +1,62 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
+#include "bench_utils.h"
+#include "bst.h"
+#include "avlbst.h"
+#include "path_avl.h"
+
+using namespace std;
+
+// Parent-pointer-free PathAVLTree against the parent-pointer AVLTree:
+// memory per node and insert / iterate / remove throughput.
+//
+// usage: path-bench [entries]
+
+template<typename Tree>
+static void run(const char* name, size_t nodeSize, const vector<int>& keys)
+{
+	size_t before = residentBytes();
+	Tree* tree = new Tree;
+
+	Stopwatch watch;
+	for(size_t i = 0; i < keys.size(); i++)
+		tree->insert(make_pair(keys[i], (char)i));
+	double insertSecs = watch.seconds();
+	size_t after = residentBytes();
+
+	watch.restart();
+	long sum = 0;
+	for(typename Tree::iterator it = tree->begin(); it != tree->end(); ++it)
+		sum += it->first;
+	double scanSecs = watch.seconds();
+
+	watch.restart();
+	for(size_t i = 0; i < keys.size(); i++)
+		tree->remove(keys[keys.size() - 1 - i]);
+	double removeSecs = watch.seconds();
+
+	cout << name << endl;
+	cout << "  sizeof(node):          " << nodeSize << endl;
+	cout << "  bytes per entry (RSS): " << (double)(after - before) / keys.size() << endl;
+	cout << "  inserts/s:             " << (uint64_t)(keys.size() / insertSecs) << endl;
+	cout << "  scan entries/s:        " << (uint64_t)(keys.size() / scanSecs) << " (checksum " << sum << ")" << endl;
+	cout << "  removes/s:             " << (uint64_t)(keys.size() / removeSecs) << endl;
+	delete tree;
+}
+
+int main(int argc, char *argv[])
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+
+	mt19937 rng(104);
+	vector<int> keys(n);
+	for(size_t i = 0; i < n; i++) keys[i] = (int)i;
+	shuffle(keys.begin(), keys.end(), rng);
+
+	run<PathAVLTree<int, char> >("PathAVLTree<int,char>", sizeof(PathNode<int, char>), keys);
+	run<AVLTree<int, char> >("AVLTree<int,char>", sizeof(AVLNode<int, char>), keys);
+	return 0;
+}
@@ -0,0 +1,563 @@
+#ifndef PATH_AVL_H
+#define PATH_AVL_H
+
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+* A node of a PathAVLTree: no parent pointer and no vtable, just the item,
+* two child pointers and the balance factor.
+*/
+template <typename Key, typename Value>
+struct PathNode
+{
+    PathNode(const Key& key, const Value& value) :
+        item(key, value), left(NULL), right(NULL), balance(0)
+    {
+
+    }
+
+    std::pair<const Key, Value> item;
+    PathNode<Key, Value>* left;
+    PathNode<Key, Value>* right;
+    int8_t balance;
+};
+
+/**
+* An AVL tree that stores no parent pointers. insert() and remove() remember the path
+* taken on the way down and rebalance along it on the way back; iterators carry an
+* explicit stack of the ancestors they still have to visit.
+*
+* Since there is nothing to patch on the way up, rotations only touch child links.
+* insert() and remove() invalidate iterators.
+*/
+template <typename Key, typename Value>
+class PathAVLTree
+{
+public:
+    typedef PathNode<Key, Value> NodeType;
+
+    PathAVLTree();
+    virtual ~PathAVLTree();
+    virtual void insert(const std::pair<const Key, Value>& keyValuePair);
+    virtual void remove(const Key& key);
+    void clear();
+    bool isBalanced() const;
+    void print() const;
+    bool empty() const;
+
+    /**
+    * An in-order iterator. The top of stack_ is the current node; below it are the
+    * ancestors whose left subtree we are in, i.e. the nodes still to be visited.
+    */
+    class iterator
+    {
+    public:
+        iterator();
+
+        std::pair<const Key,Value>& operator*() const;
+        std::pair<const Key,Value>* operator->() const;
+
+        bool operator==(const iterator& rhs) const;
+        bool operator!=(const iterator& rhs) const;
+
+        iterator& operator++();
+
+    protected:
+        friend class PathAVLTree<Key, Value>;
+        void pushLeftSpine(NodeType* n);
+        NodeType* current() const;
+        std::vector<NodeType*> stack_;
+    };
+
+    iterator begin() const;
+    iterator end() const;
+    iterator find(const Key& key) const;
+    Value& operator[](const Key& key);
+    Value const & operator[](const Key& key) const;
+
+protected:
+    // an AVL tree of 2^64 nodes is less than 93 levels deep
+    static const int MAX_DEPTH = 96;
+
+    NodeType* internalFind(const Key& key) const;
+    void relink(NodeType** path, const bool* left, int i, NodeType* child);
+    static NodeType* rotateLeft(NodeType* x);
+    static NodeType* rotateRight(NodeType* x);
+    static NodeType* rebalance(NodeType* x, int bx);
+    static int height(const NodeType* n);
+
+    NodeType* root_;
+};
+
+/*
+--------------------------------------------------------------
+Begin implementations for the PathAVLTree::iterator class.
+---------------------------------------------------------------
+*/
+
+template<class Key, class Value>
+PathAVLTree<Key, Value>::iterator::iterator()
+{
+
+}
+
+template<class Key, class Value>
+typename PathAVLTree<Key, Value>::NodeType*
+PathAVLTree<Key, Value>::iterator::current() const
+{
+    return stack_.empty() ? NULL : stack_.back();
+}
+
+template<class Key, class Value>
+void PathAVLTree<Key, Value>::iterator::pushLeftSpine(NodeType* n)
+{
+    while(n != NULL)
+    {
+        stack_.push_back(n);
+        n = n->left;
+    }
+}
+
+template<class Key, class Value>
+std::pair<const Key,Value> &
+PathAVLTree<Key, Value>::iterator::operator*() const
+{
+    return stack_.back()->item;
+}
+
+template<class Key, class Value>
+std::pair<const Key,Value> *
+PathAVLTree<Key, Value>::iterator::operator->() const
+{
+    return &(stack_.back()->item);
+}
+
+template<class Key, class Value>
+bool
+PathAVLTree<Key, Value>::iterator::operator==(const iterator& rhs) const
+{
+    return current() == rhs.current();
+}
+
+template<class Key, class Value>
+bool
+PathAVLTree<Key, Value>::iterator::operator!=(const iterator& rhs) const
+{
+    return current() != rhs.current();
+}
+
+/**
+* The successor is the leftmost node of the right subtree if there is one,
+* otherwise the nearest pending ancestor already on the stack.
+*/
+template<class Key, class Value>
+typename PathAVLTree<Key, Value>::iterator&
+PathAVLTree<Key, Value>::iterator::operator++()
+{
+    NodeType* n = stack_.back();
+    stack_.pop_back();
+    pushLeftSpine(n->right);
+    return *this;
+}
+
+/*
+-------------------------------------------------------------
+End implementations for the PathAVLTree::iterator class.
+-------------------------------------------------------------
+*/
+
+/*
+-----------------------------------------------------
+Begin implementations for the PathAVLTree class.
+-----------------------------------------------------
+*/
+
+template<class Key, class Value>
+PathAVLTree<Key, Value>::PathAVLTree() :
+    root_(NULL)
+{
+
+}
+
+template<class Key, class Value>
+PathAVLTree<Key, Value>::~PathAVLTree()
+{
+    clear();
+}
+
+template<class Key, class Value>
+bool PathAVLTree<Key, Value>::empty() const
+{
+    return root_ == NULL;
+}
+
+/**
+* Prints the contents in key order, one (key, value) pair per line.
+*/
+template<class Key, class Value>
+void PathAVLTree<Key, Value>::print() const
+{
+    if(empty())
+    {
+        std::cout << "<empty tree>" << std::endl;
+        return;
+    }
+    for(iterator it = begin(); it != end(); ++it)
+        std::cout << '(' << it->first << ", " << it->second << ')' << std::endl;
+    std::cout << "\n";
+}
+
+template<class Key, class Value>
+typename PathAVLTree<Key, Value>::iterator
+PathAVLTree<Key, Value>::begin() const
+{
+    iterator it;
+    it.pushLeftSpine(root_);
+    return it;
+}
+
+template<class Key, class Value>
+typename PathAVLTree<Key, Value>::iterator
+PathAVLTree<Key, Value>::end() const
+{
+    return iterator();
+}
+
+/**
+* Builds the iterator's stack on the way down: every node we turn left at is
+* still ahead of the found node in key order.
+*/
+template<class Key, class Value>
+typename PathAVLTree<Key, Value>::iterator
+PathAVLTree<Key, Value>::find(const Key& key) const
+{
+    iterator it;
+    NodeType* cur = root_;
+    while(cur != NULL)
+    {
+        if(key < cur->item.first)
+        {
+            it.stack_.push_back(cur);
+            cur = cur->left;
+        }
+        else if(cur->item.first < key)
+        {
+            cur = cur->right;
+        }
+        else
+        {
+            it.stack_.push_back(cur);
+            return it;
+        }
+    }
+    return end();
+}
+
+/**
+ * @precondition The key exists in the map
+ * Returns the value associated with the key
+ */
+template<class Key, class Value>
+Value& PathAVLTree<Key, Value>::operator[](const Key& key)
+{
+    NodeType* curr = internalFind(key);
+    if(curr == NULL) throw std::out_of_range("Invalid key");
+    return curr->item.second;
+}
+
+template<class Key, class Value>
+Value const & PathAVLTree<Key, Value>::operator[](const Key& key) const
+{
+    NodeType* curr = internalFind(key);
+    if(curr == NULL) throw std::out_of_range("Invalid key");
+    return curr->item.second;
+}
+
+/**
+* Makes child the new occupant of the slot path[i] was reached through:
+* the child link of path[i - 1] recorded in left[i - 1], or the root.
+*/
+template<class Key, class Value>
+void PathAVLTree<Key, Value>::relink(NodeType** path, const bool* left, int i, NodeType* child)
+{
+    if(i == 0) root_ = child;
+    else if(left[i - 1]) path[i - 1]->left = child;
+    else path[i - 1]->right = child;
+}
+
+/**
+* Descends recording the path, attaches the new leaf, and walks the recorded path
+* back up until a subtree's height stops changing or a rotation fixes it.
+* If the key is already in the tree its value is overwritten.
+*/
+template<class Key, class Value>
+void PathAVLTree<Key, Value>::insert(const std::pair<const Key, Value>& keyValuePair)
+{
+    NodeType* path[MAX_DEPTH];
+    bool left[MAX_DEPTH];
+    int depth = 0;
+    NodeType* cur = root_;
+    while(cur != NULL)
+    {
+        path[depth] = cur;
+        if(keyValuePair.first < cur->item.first)
+        {
+            left[depth++] = true;
+            cur = cur->left;
+        }
+        else if(cur->item.first < keyValuePair.first)
+        {
+            left[depth++] = false;
+            cur = cur->right;
+        }
+        else
+        {
+            cur->item.second = keyValuePair.second;
+            return;
+        }
+    }
+
+    NodeType* n = new NodeType(keyValuePair.first, keyValuePair.second);
+    relink(path, left, depth, n);
+
+    for(int i = depth - 1; i >= 0; --i)
+    {
+        NodeType* p = path[i];
+        int b = p->balance + (left[i] ? -1 : 1);
+        if(b == 0)
+        {
+            p->balance = 0;
+            return;
+        }
+        if(b == 1 || b == -1)
+        {
+            p->balance = (int8_t)b;
+            continue;
+        }
+        relink(path, left, i, rebalance(p, b));
+        return;
+    }
+}
+
+/**
+* Descends recording the path. A node with two children is replaced by its
+* predecessor, which is found by continuing the same descent, so the recorded path
+* always ends just above the node that is physically unlinked.
+*/
+template<class Key, class Value>
+void PathAVLTree<Key, Value>::remove(const Key& key)
+{
+    NodeType* path[MAX_DEPTH];
+    bool left[MAX_DEPTH];
+    int depth = 0;
+    NodeType* z = root_;
+    while(z != NULL)
+    {
+        if(key < z->item.first)
+        {
+            path[depth] = z;
+            left[depth++] = true;
+            z = z->left;
+        }
+        else if(z->item.first < key)
+        {
+            path[depth] = z;
+            left[depth++] = false;
+            z = z->right;
+        }
+        else break;
+    }
+    if(z == NULL) return;
+
+    if(z->left != NULL && z->right != NULL)
+    {
+        int zi = depth;
+        path[depth] = z;
+        left[depth++] = true;
+        NodeType* d = z->left;
+        while(d->right != NULL)
+        {
+            path[depth] = d;
+            left[depth++] = false;
+            d = d->right;
+        }
+        // unlink the predecessor, then let it take z's place
+        relink(path, left, depth, d->left);
+        d->left = z->left;
+        d->right = z->right;
+        d->balance = z->balance;
+        relink(path, left, zi, d);
+        path[zi] = d;
+    }
+    else
+    {
+        relink(path, left, depth, z->left != NULL ? z->left : z->right);
+    }
+    delete z;
+
+    for(int i = depth - 1; i >= 0; --i)
+    {
+        NodeType* p = path[i];
+        int b = p->balance + (left[i] ? 1 : -1);
+        if(b == 1 || b == -1)
+        {
+            p->balance = (int8_t)b;
+            return;
+        }
+        if(b == 0)
+        {
+            p->balance = 0;
+            continue;
+        }
+        NodeType* top = rebalance(p, b);
+        relink(path, left, i, top);
+        // the subtree kept its height, nothing above it changes
+        if(top->balance != 0) return;
+    }
+}
+
+template<class Key, class Value>
+typename PathAVLTree<Key, Value>::NodeType*
+PathAVLTree<Key, Value>::rotateLeft(NodeType* x)
+{
+    NodeType* y = x->right;
+    x->right = y->left;
+    y->left = x;
+    return y;
+}
+
+template<class Key, class Value>
+typename PathAVLTree<Key, Value>::NodeType*
+PathAVLTree<Key, Value>::rotateRight(NodeType* x)
+{
+    NodeType* y = x->left;
+    x->left = y->right;
+    y->right = x;
+    return y;
+}
+
+/**
+* Fixes node x whose balance would be bx (+2 or -2) with a single or double rotation
+* and returns the new root of the subtree; the caller links it in.
+*/
+template<class Key, class Value>
+typename PathAVLTree<Key, Value>::NodeType*
+PathAVLTree<Key, Value>::rebalance(NodeType* x, int bx)
+{
+    if(bx > 0)
+    {
+        NodeType* y = x->right;
+        int by = y->balance;
+        if(by >= 0)
+        {
+            rotateLeft(x);
+            x->balance = (int8_t)(by == 0 ? 1 : 0);
+            y->balance = (int8_t)(by == 0 ? -1 : 0);
+            return y;
+        }
+        NodeType* z = y->left;
+        int bz = z->balance;
+        x->right = rotateRight(y);
+        rotateLeft(x);
+        x->balance = (int8_t)(bz == 1 ? -1 : 0);
+        y->balance = (int8_t)(bz == -1 ? 1 : 0);
+        z->balance = 0;
+        return z;
+    }
+    else
+    {
+        NodeType* y = x->left;
+        int by = y->balance;
+        if(by <= 0)
+        {
+            rotateRight(x);
+            x->balance = (int8_t)(by == 0 ? -1 : 0);
+            y->balance = (int8_t)(by == 0 ? 1 : 0);
+            return y;
+        }
+        NodeType* z = y->right;
+        int bz = z->balance;
+        x->left = rotateLeft(y);
+        rotateRight(x);
+        x->balance = (int8_t)(bz == -1 ? 1 : 0);
+        y->balance = (int8_t)(bz == 1 ? -1 : 0);
+        z->balance = 0;
+        return z;
+    }
+}
+
+/**
+* Deletes every node without recursion or an auxiliary stack: left children are
+* rotated up until the current node has none, then it is freed.
+*/
+template<class Key, class Value>
+void PathAVLTree<Key, Value>::clear()
+{
+    NodeType* cur = root_;
+    while(cur != NULL)
+    {
+        if(cur->left != NULL)
+        {
+            NodeType* l = cur->left;
+            cur->left = l->right;
+            l->right = cur;
+            cur = l;
+        }
+        else
+        {
+            NodeType* next = cur->right;
+            delete cur;
+            cur = next;
+        }
+    }
+    root_ = NULL;
+}
+
+template<class Key, class Value>
+typename PathAVLTree<Key, Value>::NodeType*
+PathAVLTree<Key, Value>::internalFind(const Key& key) const
+{
+    NodeType* cur = root_;
+    while(cur != NULL)
+    {
+        if(key < cur->item.first) cur = cur->left;
+        else if(cur->item.first < key) cur = cur->right;
+        else return cur;
+    }
+    return NULL;
+}
+
+/**
+ * Return true iff the tree is balanced. Heights are recomputed rather than trusting
+ * the stored balance factors.
+ */
+template<class Key, class Value>
+bool PathAVLTree<Key, Value>::isBalanced() const
+{
+    return height(root_) >= 0;
+}
+
+// Height of the subtree at n, or -1 if some node in it is out of balance.
+template<class Key, class Value>
+int PathAVLTree<Key, Value>::height(const NodeType* n)
+{
+    if(n == NULL) return 0;
+    int l = height(n->left);
+    int r = height(n->right);
+    if(l < 0 || r < 0 || abs(l - r) > 1) return -1;
+    return (l > r ? l : r) + 1;
+}
+
+/*
+---------------------------------------------------
+End implementations for the PathAVLTree class.
+---------------------------------------------------
+*/
+
+#endif
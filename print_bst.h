@@ -13,54 +13,33 @@
 // maximum depth of tree to actually print.
 #define PPBST_MAX_HEIGHT 6
 
-// Returns the node's distance from the given root.
-// 1 means that it is the root.
-// Returns -1 (not found) if the distance is more than PPBST_MAX_HEIGHT,
-// or -2 if the tree is inconsistent.
-template<typename Key, typename Value>
-int getNodeDepth(BinarySearchTree<Key, Value> const & tree, Node<Key, Value> * root, Node<Key, Value> * node)
-{
-    int dist = 1;
-
-    while(node != root)
-    {
-        if(node == nullptr)
-        {
-            return -2;
-        }
-
-        ++dist;
-        node = node->getParent();
-
-        if(dist > PPBST_MAX_HEIGHT)
-        {
-            return -1;
-        }
-    }
-
-    return dist;
-}
-
 // Returns the height of the subtree at root.
-// Uses recursion, not height values, so it is bulletproof
+// Counts the levels, not height values, so it is bulletproof
 // against incorrect heights.
-// Stops recursing after PPBST_MAX_HEIGHT calls.
+// Stops counting after PPBST_MAX_HEIGHT levels, so it takes bounded
+// time and stack however deep the tree is.
 template<typename Key, typename Value>
-int getSubtreeHeight(Node<Key, Value> * root, int recursionDepth = 1)
+int getSubtreeHeight(Node<Key, Value> * root)
 {
-    if(root == nullptr)
+    int height = 0;
+    std::vector<Node<Key, Value> *> level;
+    if(root != nullptr)
     {
-        return 0;
+        level.push_back(root);
     }
 
-    if(recursionDepth > PPBST_MAX_HEIGHT)
+    while(!level.empty() && height < PPBST_MAX_HEIGHT)
     {
-        // bail out to prevent infinite loops on bad trees
-        return 0;
+        ++height;
+        std::vector<Node<Key, Value> *> next;
+        for(size_t i = 0; i < level.size(); ++i)
+        {
+            if(level[i]->getLeft() != nullptr) next.push_back(level[i]->getLeft());
+            if(level[i]->getRight() != nullptr) next.push_back(level[i]->getRight());
+        }
+        level.swap(next);
     }
-
-    return std::max(getSubtreeHeight(root->getLeft(), recursionDepth + 1),
-                    getSubtreeHeight(root->getRight(), recursionDepth + 1)) + 1;
+    return height;
 }
 
 /* Function to prettily print a BST out to the terminal.
@@ -129,17 +108,29 @@ void BinarySearchTree<Key, Value>::printRoot (Node<Key, Value>* root) const
     // ----------------------------------------------------------------------
     std::map<Key, uint8_t> valuePlaceholders;
 
-    uint8_t nextPlaceHolderVal = 1;
-    for(typename BinarySearchTree<Key, Value>::iterator treeIter = this->begin(); treeIter != this->end(); ++treeIter)
+    // only the printed levels are numbered, so a deep tree costs no more than a shallow one
+    std::vector<Node<Key, Value> *> printedNodes(1, root);
+    for(size_t levelStart = 0, level = 1; level < printedTreeHeight; ++level)
     {
-
-        if(getNodeDepth(*this, root, treeIter.current_) != -1)
+        size_t levelEnd = printedNodes.size();
+        for(size_t i = levelStart; i < levelEnd; ++i)
         {
-            // note; the iterator will traverse in sorted order so values should get the same placeholders between
-            // different calls as long as the tree is the same
-            valuePlaceholders.insert(std::make_pair(treeIter->first, nextPlaceHolderVal++));
+            if(printedNodes[i]->getLeft() != nullptr) printedNodes.push_back(printedNodes[i]->getLeft());
+            if(printedNodes[i]->getRight() != nullptr) printedNodes.push_back(printedNodes[i]->getRight());
         }
+        levelStart = levelEnd;
+    }
+    for(size_t i = 0; i < printedNodes.size(); ++i)
+    {
+        valuePlaceholders.insert(std::make_pair(printedNodes[i]->getKey(), 0));
+    }
 
+    // numbered in key order, so values get the same placeholders between
+    // different calls as long as the tree is the same
+    uint8_t nextPlaceHolderVal = 1;
+    for(typename std::map<Key, uint8_t>::iterator placeholderIter = valuePlaceholders.begin(); placeholderIter != valuePlaceholders.end(); ++placeholderIter)
+    {
+        placeholderIter->second = nextPlaceHolderVal++;
     }
 
     // print tree
@@ -258,7 +249,7 @@ void BinarySearchTree<Key, Value>::printRoot (Node<Key, Value>* root) const
     std::cout << std::endl;
     if(clippedFinalElements)
     {
-        std::cout << "(deeper levels omitted due to space limitations)" << std::endl;
+        std::cout << "(deeper levels omitted due to space limitations; exportDot() shows them all)" << std::endl;
     }
 
 
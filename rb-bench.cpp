@@ -0,0 +1,100 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
+#include "bench_utils.h"
+#include "bst.h"
+#include "avlbst.h"
+#include "rbbst.h"
+
+using namespace std;
+
+// RedBlackTree against AVLTree: insert, lookup and remove throughput, a write-heavy
+// mix, and the height each tree ends up with.
+//
+// usage: rb-bench [entries]
+//
+// Runs once with the keys in random order and once in ascending order. The mix is
+// 70% updates (half inserts of new keys, half removes) and 30% lookups.
+// Build with DEFS=-DBST_STATS to also see how many rotations each tree did.
+
+template<typename Tree>
+static void run(const char* name, const vector<int>& keys, const vector<int>& probes)
+{
+	Tree tree;
+	tree.resetStats();
+
+	Stopwatch watch;
+	for(size_t i = 0; i < keys.size(); i++)
+		tree.insert(make_pair(keys[i], (int)i));
+	double insertSecs = watch.seconds();
+	TreeStats afterInsert = tree.stats();
+
+	watch.restart();
+	size_t hits = 0;
+	for(size_t i = 0; i < probes.size(); i++)
+		if(tree.find(probes[i]) != tree.end()) hits++;
+	double lookupSecs = watch.seconds();
+	size_t lookupHits = hits;
+
+	// new keys come from above the loaded range; removes take loaded keys in order
+	watch.restart();
+	mt19937 rng(104);
+	uniform_int_distribution<int> percent(0, 99);
+	int nextKey = (int)keys.size();
+	size_t removed = 0;
+	for(size_t i = 0; i < keys.size(); i++)
+	{
+		int roll = percent(rng);
+		if(roll < 35) tree.insert(make_pair(nextKey++, (int)i));
+		else if(roll < 70) tree.remove(keys[removed++]);
+		else if(tree.find(probes[i]) != tree.end()) hits++;
+	}
+	double mixSecs = watch.seconds();
+	int mixHeight = tree.profile().height;
+
+	// what the mix left behind, so every remove hits
+	watch.restart();
+	for(size_t i = removed; i < keys.size(); i++)
+		tree.remove(keys[i]);
+	for(int key = (int)keys.size(); key < nextKey; key++)
+		tree.remove(key);
+	double removeSecs = watch.seconds();
+	size_t removes = keys.size() - removed + (nextKey - keys.size());
+	TreeStats total = tree.stats();
+
+	cout << "  " << name << endl;
+	cout << "    inserts/s:           " << (uint64_t)(keys.size() / insertSecs) << endl;
+	cout << "    height after load:   " << afterInsert.height << endl;
+	cout << "    lookups/s:           " << (uint64_t)(probes.size() / lookupSecs) << " (" << lookupHits << " hits)" << endl;
+	cout << "    70% write mix ops/s: " << (uint64_t)(keys.size() / mixSecs) << " (" << hits - lookupHits << " hits)" << endl;
+	cout << "    height after mix:    " << mixHeight << endl;
+	cout << "    removes/s:           " << (uint64_t)(removes / removeSecs) << endl;
+#ifdef BST_STATS
+	cout << "    rotations:           " << total.singleRotations + 2 * total.doubleRotations << endl;
+#else
+	(void)total;
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+
+	mt19937 rng(104);
+	vector<int> keys(n);
+	for(size_t i = 0; i < n; i++) keys[i] = (int)i;
+	vector<int> probes(keys);
+	shuffle(probes.begin(), probes.end(), rng);
+
+	cout << "ascending keys" << endl;
+	run<RedBlackTree<int, int> >("RedBlackTree<int,int>", keys, probes);
+	run<AVLTree<int, int> >("AVLTree<int,int>", keys, probes);
+
+	shuffle(keys.begin(), keys.end(), rng);
+	cout << "random keys" << endl;
+	run<RedBlackTree<int, int> >("RedBlackTree<int,int>", keys, probes);
+	run<AVLTree<int, int> >("AVLTree<int,int>", keys, probes);
+	return 0;
+}
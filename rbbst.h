@@ -0,0 +1,435 @@
+#ifndef RBBST_H
+#define RBBST_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <cstdint>
+#include <utility>
+#include "bst.h"
+
+/**
+* A node of a RedBlackTree. The color lives in the low bit of the parent pointer,
+* which alignment leaves free, so an RBNode is exactly as big as a plain Node.
+* getParent() masks the bit off, so the BinarySearchTree iterator and other read-only
+* code work unchanged. Writes must go through RBNode::setParent(), which keeps the
+* color; Node::setParent() through a Node pointer would clear it.
+*/
+template <typename Key, typename Value>
+class RBNode : public Node<Key, Value>
+{
+public:
+    // new nodes are red
+    RBNode(const Key& key, const Value& value, RBNode<Key, Value>* parent);
+    virtual ~RBNode();
+
+    bool isRed() const;
+    void setRed(bool red);
+
+    virtual RBNode<Key, Value>* getParent() const override;
+    virtual RBNode<Key, Value>* getLeft() const override;
+    virtual RBNode<Key, Value>* getRight() const override;
+
+    void setParent(RBNode<Key, Value>* parent);
+
+protected:
+    static const uintptr_t RED_BIT = 1;
+};
+
+/*
+  -----------------------------------------------
+  Begin implementations for the RBNode class.
+  -----------------------------------------------
+*/
+
+template<class Key, class Value>
+RBNode<Key, Value>::RBNode(const Key& key, const Value& value, RBNode<Key, Value>* parent) :
+    Node<Key, Value>(key, value, NULL)
+{
+    static_assert(alignof(Node<Key, Value>) > 1, "RBNode needs a free low bit in its parent pointer");
+    this->parent_ = reinterpret_cast<Node<Key, Value>*>(reinterpret_cast<uintptr_t>(parent) | RED_BIT);
+}
+
+template<class Key, class Value>
+RBNode<Key, Value>::~RBNode()
+{
+
+}
+
+template<class Key, class Value>
+bool RBNode<Key, Value>::isRed() const
+{
+    return (reinterpret_cast<uintptr_t>(this->parent_) & RED_BIT) != 0;
+}
+
+template<class Key, class Value>
+void RBNode<Key, Value>::setRed(bool red)
+{
+    uintptr_t bits = reinterpret_cast<uintptr_t>(this->parent_) & ~RED_BIT;
+    this->parent_ = reinterpret_cast<Node<Key, Value>*>(bits | (red ? RED_BIT : 0));
+}
+
+/**
+* Returns the parent without the color bit.
+*/
+template<class Key, class Value>
+RBNode<Key, Value> *RBNode<Key, Value>::getParent() const
+{
+    uintptr_t bits = reinterpret_cast<uintptr_t>(this->parent_) & ~RED_BIT;
+    return static_cast<RBNode<Key, Value>*>(reinterpret_cast<Node<Key, Value>*>(bits));
+}
+
+template<class Key, class Value>
+RBNode<Key, Value> *RBNode<Key, Value>::getLeft() const
+{
+    return static_cast<RBNode<Key, Value>*>(this->left_);
+}
+
+template<class Key, class Value>
+RBNode<Key, Value> *RBNode<Key, Value>::getRight() const
+{
+    return static_cast<RBNode<Key, Value>*>(this->right_);
+}
+
+/**
+* Sets the parent, keeping the color.
+*/
+template<class Key, class Value>
+void RBNode<Key, Value>::setParent(RBNode<Key, Value>* parent)
+{
+    uintptr_t color = reinterpret_cast<uintptr_t>(this->parent_) & RED_BIT;
+    this->parent_ = reinterpret_cast<Node<Key, Value>*>(reinterpret_cast<uintptr_t>(parent) | color);
+}
+
+/*
+  -----------------------------------------------
+  End implementations for the RBNode class.
+  -----------------------------------------------
+*/
+
+/**
+* A red-black tree (as in CLRS). Heights stay within 2 log(n+1), a little looser than
+* AVLTree's 1.44 log n, in exchange for cheaper updates: insert() rotates at most twice
+* and remove() at most three times, and most of the fixing up is recoloring.
+*/
+template <class Key, class Value>
+class RedBlackTree : public BinarySearchTree<Key, Value>
+{
+public:
+    virtual void insert(const std::pair<const Key, Value>& new_item);
+    virtual void remove(const Key& key);
+
+protected:
+    RBNode<Key, Value>* root() const;
+    static bool isRed(const RBNode<Key, Value>* n);
+    void rotateLeft(RBNode<Key, Value>* n);
+    void rotateRight(RBNode<Key, Value>* n);
+    void replaceChild(RBNode<Key, Value>* parent, RBNode<Key, Value>* oldChild, RBNode<Key, Value>* newChild);
+    void insertFix(RBNode<Key, Value>* n);
+    void removeFix(RBNode<Key, Value>* n, RBNode<Key, Value>* parent);
+};
+
+/*
+  -----------------------------------------------
+  Begin implementations for the RedBlackTree class.
+  -----------------------------------------------
+*/
+
+/**
+* Inserts like a plain BST, as a red leaf, then repairs any red node with a red parent.
+* An existing key just gets the new value.
+*/
+template<class Key, class Value>
+void RedBlackTree<Key, Value>::insert(const std::pair<const Key, Value>& new_item)
+{
+    BST_STATS_OP(TREE_OP_INSERT);
+    if(this->trace_ != NULL) this->trace_->record(TRACE_INSERT, new_item.first);
+
+    RBNode<Key, Value>* parent = NULL;
+    RBNode<Key, Value>* cur = root();
+    int depth = 0;
+    while(cur != NULL)
+    {
+        BST_STATS_VISIT();
+        BST_STATS_DEPTH(++depth);
+        BST_STATS_COMPARE(1);
+        if(new_item.first == cur->getKey())
+        {
+            cur->setValue(new_item.second);
+            return;
+        }
+        parent = cur;
+        cur = new_item.first < cur->getKey() ? cur->getLeft() : cur->getRight();
+    }
+
+    RBNode<Key, Value>* n = new RBNode<Key, Value>(new_item.first, new_item.second, parent);
+    this->rememberKey(new_item.first);
+    if(parent == NULL) this->root_ = n;
+    else if(new_item.first < parent->getKey()) parent->setLeft(n);
+    else parent->setRight(n);
+    insertFix(n);
+}
+
+/**
+* Removes key if present. A node with two children first trades places with its
+* successor, so the node actually unlinked has at most one child.
+*/
+template<class Key, class Value>
+void RedBlackTree<Key, Value>::remove(const Key& key)
+{
+    BST_STATS_OP(TREE_OP_REMOVE);
+    if(this->trace_ != NULL) this->trace_->record(TRACE_REMOVE, key);
+
+    RBNode<Key, Value>* n = static_cast<RBNode<Key, Value>*>(this->internalFind(key));
+    if(n == NULL) return;
+
+    // child takes the place of the node unlinked; parent is where that happens
+    RBNode<Key, Value>* child;
+    RBNode<Key, Value>* parent;
+    bool removedRed;
+    if(n->getLeft() == NULL || n->getRight() == NULL)
+    {
+        child = n->getLeft() != NULL ? n->getLeft() : n->getRight();
+        parent = n->getParent();
+        removedRed = n->isRed();
+        replaceChild(parent, n, child);
+        if(child != NULL) child->setParent(parent);
+    }
+    else
+    {
+        RBNode<Key, Value>* next = n->getRight();
+        while(next->getLeft() != NULL) next = next->getLeft();
+        // next moves into n's place and color, so a node of next's color leaves its spot
+        removedRed = next->isRed();
+        child = next->getRight();
+        if(next->getParent() == n)
+        {
+            parent = next;
+        }
+        else
+        {
+            parent = next->getParent();
+            parent->setLeft(child);
+            if(child != NULL) child->setParent(parent);
+            next->setRight(n->getRight());
+            n->getRight()->setParent(next);
+        }
+        replaceChild(n->getParent(), n, next);
+        next->setParent(n->getParent());
+        next->setLeft(n->getLeft());
+        n->getLeft()->setParent(next);
+        next->setRed(n->isRed());
+    }
+    this->forgetNode(n);
+    delete n;
+
+    if(!removedRed) removeFix(child, parent);
+}
+
+template<class Key, class Value>
+RBNode<Key, Value>* RedBlackTree<Key, Value>::root() const
+{
+    return static_cast<RBNode<Key, Value>*>(this->root_);
+}
+
+/**
+* NULL children count as black.
+*/
+template<class Key, class Value>
+bool RedBlackTree<Key, Value>::isRed(const RBNode<Key, Value>* n)
+{
+    return n != NULL && n->isRed();
+}
+
+/**
+* Points parent's link to oldChild (or the root, if parent is NULL) at newChild.
+*/
+template<class Key, class Value>
+void RedBlackTree<Key, Value>::replaceChild(RBNode<Key, Value>* parent, RBNode<Key, Value>* oldChild, RBNode<Key, Value>* newChild)
+{
+    if(parent == NULL) this->root_ = newChild;
+    else if(parent->getLeft() == oldChild) parent->setLeft(newChild);
+    else parent->setRight(newChild);
+}
+
+/**
+* Rotates n's right child up into n's place.
+*/
+template<class Key, class Value>
+void RedBlackTree<Key, Value>::rotateLeft(RBNode<Key, Value>* n)
+{
+    RBNode<Key, Value>* r = n->getRight();
+    n->setRight(r->getLeft());
+    if(r->getLeft() != NULL) r->getLeft()->setParent(n);
+    replaceChild(n->getParent(), n, r);
+    r->setParent(n->getParent());
+    r->setLeft(n);
+    n->setParent(r);
+}
+
+/**
+* Rotates n's left child up into n's place.
+*/
+template<class Key, class Value>
+void RedBlackTree<Key, Value>::rotateRight(RBNode<Key, Value>* n)
+{
+    RBNode<Key, Value>* l = n->getLeft();
+    n->setLeft(l->getRight());
+    if(l->getRight() != NULL) l->getRight()->setParent(n);
+    replaceChild(n->getParent(), n, l);
+    l->setParent(n->getParent());
+    l->setRight(n);
+    n->setParent(l);
+}
+
+/**
+* Walks up from the red node n while its parent is red too. A red uncle means the
+* grandparent's blackness can be pushed down and the problem moved two levels up;
+* otherwise one or two rotations finish the job.
+*/
+template<class Key, class Value>
+void RedBlackTree<Key, Value>::insertFix(RBNode<Key, Value>* n)
+{
+    while(isRed(n->getParent()))
+    {
+        RBNode<Key, Value>* parent = n->getParent();
+        // a red parent is never the root, so there is a grandparent
+        RBNode<Key, Value>* grand = parent->getParent();
+        bool parentIsLeft = grand->getLeft() == parent;
+        RBNode<Key, Value>* uncle = parentIsLeft ? grand->getRight() : grand->getLeft();
+        if(isRed(uncle))
+        {
+            parent->setRed(false);
+            uncle->setRed(false);
+            grand->setRed(true);
+            n = grand;
+            continue;
+        }
+
+        if(parentIsLeft)
+        {
+            if(n == parent->getRight())
+            {
+                BST_STATS_COUNT(doubleRotations);
+                rotateLeft(parent);
+                parent = n;
+            }
+            else
+            {
+                BST_STATS_COUNT(singleRotations);
+            }
+            rotateRight(grand);
+        }
+        else
+        {
+            if(n == parent->getLeft())
+            {
+                BST_STATS_COUNT(doubleRotations);
+                rotateRight(parent);
+                parent = n;
+            }
+            else
+            {
+                BST_STATS_COUNT(singleRotations);
+            }
+            rotateLeft(grand);
+        }
+        parent->setRed(false);
+        grand->setRed(true);
+        break;
+    }
+    root()->setRed(false);
+}
+
+/**
+* Restores equal black heights after a black node was unlinked from under parent,
+* leaving n (possibly NULL) one black short. Walks up while n is black and recolors
+* or rotates around its sibling; at most three rotations are done in total.
+*/
+template<class Key, class Value>
+void RedBlackTree<Key, Value>::removeFix(RBNode<Key, Value>* n, RBNode<Key, Value>* parent)
+{
+    while(n != root() && !isRed(n))
+    {
+        if(n == parent->getLeft())
+        {
+            RBNode<Key, Value>* sibling = parent->getRight();
+            if(isRed(sibling))
+            {
+                BST_STATS_COUNT(singleRotations);
+                sibling->setRed(false);
+                parent->setRed(true);
+                rotateLeft(parent);
+                sibling = parent->getRight();
+            }
+            if(!isRed(sibling->getLeft()) && !isRed(sibling->getRight()))
+            {
+                sibling->setRed(true);
+                n = parent;
+                parent = n->getParent();
+                continue;
+            }
+            if(!isRed(sibling->getRight()))
+            {
+                BST_STATS_COUNT(doubleRotations);
+                sibling->getLeft()->setRed(false);
+                sibling->setRed(true);
+                rotateRight(sibling);
+                sibling = parent->getRight();
+            }
+            else
+            {
+                BST_STATS_COUNT(singleRotations);
+            }
+            sibling->setRed(parent->isRed());
+            parent->setRed(false);
+            sibling->getRight()->setRed(false);
+            rotateLeft(parent);
+        }
+        else
+        {
+            RBNode<Key, Value>* sibling = parent->getLeft();
+            if(isRed(sibling))
+            {
+                BST_STATS_COUNT(singleRotations);
+                sibling->setRed(false);
+                parent->setRed(true);
+                rotateRight(parent);
+                sibling = parent->getLeft();
+            }
+            if(!isRed(sibling->getLeft()) && !isRed(sibling->getRight()))
+            {
+                sibling->setRed(true);
+                n = parent;
+                parent = n->getParent();
+                continue;
+            }
+            if(!isRed(sibling->getLeft()))
+            {
+                BST_STATS_COUNT(doubleRotations);
+                sibling->getRight()->setRed(false);
+                sibling->setRed(true);
+                rotateLeft(sibling);
+                sibling = parent->getLeft();
+            }
+            else
+            {
+                BST_STATS_COUNT(singleRotations);
+            }
+            sibling->setRed(parent->isRed());
+            parent->setRed(false);
+            sibling->getLeft()->setRed(false);
+            rotateRight(parent);
+        }
+        n = root();
+    }
+    if(n != NULL) n->setRed(false);
+}
+
+/*
+  -----------------------------------------------
+  End implementations for the RedBlackTree class.
+  -----------------------------------------------
+*/
+
+#endif
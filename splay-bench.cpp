@@ -0,0 +1,78 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
+#include "bench_utils.h"
+#include "bst.h"
+#include "avlbst.h"
+#include "splay_tree.h"
+
+using namespace std;
+
+// SplayTree against AVLTree under zipfian lookups of increasing skew.
+//
+// usage: splay-bench [entries] [lookups]
+//
+// For each skew the tree holds keys 0..entries-1, inserted in random order, and is
+// then probed with zipfian keys whose popular ranks are scattered over the key space.
+// A 90/10 lookup/update mix follows, where updates reinsert existing keys.
+
+static const double SKEWS[] = { 0.5, 0.8, 0.99, 1.2, 1.5 };
+
+template<typename Tree>
+static void run(const char* name, const vector<int>& keys, const vector<int>& probes)
+{
+	Tree tree;
+	for(size_t i = 0; i < keys.size(); i++)
+		tree.insert(make_pair(keys[i], (int)i));
+
+	Stopwatch watch;
+	size_t hits = 0;
+	for(size_t i = 0; i < probes.size(); i++)
+		if(tree.find(probes[i]) != tree.end()) hits++;
+	double lookupSecs = watch.seconds();
+
+	watch.restart();
+	size_t mixedHits = 0;
+	for(size_t i = 0; i < probes.size(); i++)
+	{
+		if(i % 10 == 0) tree.insert(make_pair(probes[i], (int)i));
+		else if(tree.find(probes[i]) != tree.end()) mixedHits++;
+	}
+	double mixedSecs = watch.seconds();
+
+	cout << "  " << name << endl;
+	cout << "    lookups/s:           " << (uint64_t)(probes.size() / lookupSecs) << " (" << hits << " hits)" << endl;
+	cout << "    90/10 mix ops/s:     " << (uint64_t)(probes.size() / mixedSecs) << " (" << mixedHits << " hits)" << endl;
+	cout << "    final height:        " << tree.profile().height << endl;
+}
+
+int main(int argc, char *argv[])
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+	size_t lookups = argc > 2 ? strtoul(argv[2], NULL, 10) : 4000000;
+	if(n == 0)
+	{
+		cerr << "usage: " << argv[0] << " [entries > 0] [lookups]" << endl;
+		return 1;
+	}
+
+	mt19937_64 rng(104);
+	vector<int> keys(n);
+	for(size_t i = 0; i < n; i++) keys[i] = (int)i;
+	shuffle(keys.begin(), keys.end(), rng);
+
+	for(size_t s = 0; s < sizeof(SKEWS) / sizeof(SKEWS[0]); s++)
+	{
+		ZipfGenerator zipf(n, SKEWS[s]);
+		vector<int> probes(lookups);
+		for(size_t i = 0; i < lookups; i++)
+			probes[i] = (int)((zipf(rng) * 0x9E3779B97F4A7C15ull) % n);
+
+		cout << "zipf " << SKEWS[s] << endl;
+		run<SplayTree<int, int> >("SplayTree<int,int>", keys, probes);
+		run<AVLTree<int, int> >("AVLTree<int,int>", keys, probes);
+	}
+	return 0;
+}
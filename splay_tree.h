@@ -0,0 +1,266 @@
+#ifndef SPLAY_TREE_H
+#define SPLAY_TREE_H
+
+#include <iostream>
+#include <exception>
+#include <stdexcept>
+#include <cstdlib>
+#include <utility>
+#include "bst.h"
+
+/**
+* A self-adjusting binary search tree (Sleator and Tarjan). find(), insert(), remove()
+* and the non-const operator[] splay the key they look for to the root in a single
+* top-down pass, so recently used keys stay near the top: reaching a key that takes a
+* fraction p of the accesses costs O(log 1/p) amortized. Any m operations take
+* O(m log n), though a single one can take O(n).
+*
+* It uses plain Nodes and the BinarySearchTree iterator. Splaying moves nodes but never
+* frees them, so iterators stay valid across everything but removing their own node.
+* The const find() and operator[] cannot restructure the tree and simply search it.
+* The Bloom filter and the lookup cache are asked before splaying: a key the filter
+* turns away or the cache holds is answered without touching the tree's shape.
+*/
+template <typename Key, typename Value>
+class SplayTree : public BinarySearchTree<Key, Value>
+{
+public:
+    typedef typename BinarySearchTree<Key, Value>::iterator iterator;
+
+    virtual void insert(const std::pair<const Key, Value>& keyValuePair);
+    virtual void remove(const Key& key);
+
+    using BinarySearchTree<Key, Value>::find;
+    using BinarySearchTree<Key, Value>::operator[];
+    iterator find(const Key& key);
+    Value& operator[](const Key& key);
+
+protected:
+    Node<Key, Value>* splay(Node<Key, Value>* top, const Key& key);
+    // key's node, or NULL if key is missing
+    Node<Key, Value>* lookupSplay(const Key& key);
+};
+
+/*
+--------------------------------------------------------------
+Begin implementations for the SplayTree class.
+--------------------------------------------------------------
+*/
+
+/**
+* Splays key to the root and inserts it there, or overwrites its value if present.
+*/
+template<typename Key, typename Value>
+void SplayTree<Key, Value>::insert(const std::pair<const Key, Value>& keyValuePair)
+{
+    BST_STATS_OP(TREE_OP_INSERT);
+    if(this->trace_ != NULL) this->trace_->record(TRACE_INSERT, keyValuePair.first);
+    const Key& key = keyValuePair.first;
+    if(this->root_ == NULL)
+    {
+        this->root_ = new Node<Key, Value>(key, keyValuePair.second, NULL);
+        this->rememberKey(key);
+        return;
+    }
+
+    Node<Key, Value>* top = splay(this->root_, key);
+    if(top->getKey() == key)
+    {
+        top->setValue(keyValuePair.second);
+        this->root_ = top;
+        return;
+    }
+
+    // top is key's neighbour, so the new root splits the tree right at it
+    Node<Key, Value>* n = new Node<Key, Value>(key, keyValuePair.second, NULL);
+    this->rememberKey(key);
+    if(key < top->getKey())
+    {
+        n->setLeft(top->getLeft());
+        if(top->getLeft() != NULL) top->getLeft()->setParent(n);
+        top->setLeft(NULL);
+        n->setRight(top);
+    }
+    else
+    {
+        n->setRight(top->getRight());
+        if(top->getRight() != NULL) top->getRight()->setParent(n);
+        top->setRight(NULL);
+        n->setLeft(top);
+    }
+    top->setParent(n);
+    this->root_ = n;
+}
+
+/**
+* Splays key to the root and, if it is there, joins its two subtrees by splaying the
+* largest key of the left one up to take its place.
+*/
+template<typename Key, typename Value>
+void SplayTree<Key, Value>::remove(const Key& key)
+{
+    BST_STATS_OP(TREE_OP_REMOVE);
+    if(this->trace_ != NULL) this->trace_->record(TRACE_REMOVE, key);
+    if(this->root_ == NULL) return;
+
+    Node<Key, Value>* top = splay(this->root_, key);
+    this->root_ = top;
+    if(!(top->getKey() == key)) return;
+
+    Node<Key, Value>* left = top->getLeft();
+    Node<Key, Value>* right = top->getRight();
+    if(left == NULL)
+    {
+        this->root_ = right;
+        if(right != NULL) right->setParent(NULL);
+    }
+    else
+    {
+        left->setParent(NULL);
+        // key is above everything on the left, so this brings up its maximum,
+        // which has no right child
+        left = splay(left, key);
+        left->setRight(right);
+        if(right != NULL) right->setParent(left);
+        this->root_ = left;
+    }
+    this->forgetNode(top);
+    delete top;
+}
+
+template<typename Key, typename Value>
+typename SplayTree<Key, Value>::iterator SplayTree<Key, Value>::find(const Key& key)
+{
+    BST_STATS_OP(TREE_OP_FIND);
+    if(this->trace_ != NULL) this->trace_->record(TRACE_FIND, key);
+    return this->iteratorAt(lookupSplay(key));
+}
+
+template<typename Key, typename Value>
+Value& SplayTree<Key, Value>::operator[](const Key& key)
+{
+    BST_STATS_OP(TREE_OP_FIND);
+    if(this->trace_ != NULL) this->trace_->record(TRACE_FIND, key);
+    Node<Key, Value>* n = lookupSplay(key);
+    if(n == NULL) throw std::out_of_range("Invalid key");
+    return n->getValue();
+}
+
+/**
+* lookupNode() with the search replaced by a splay, after which key, if present, is at
+* the root.
+*/
+template<typename Key, typename Value>
+Node<Key, Value>* SplayTree<Key, Value>::lookupSplay(const Key& key)
+{
+    Node<Key, Value>* n;
+    if(!this->screenLookup(key, n)) return NULL;
+    if(n != NULL || this->root_ == NULL) return n;
+    this->root_ = splay(this->root_, key);
+    return this->finishLookup(key, this->root_->getKey() == key ? this->root_ : NULL);
+}
+
+/**
+* Top-down splay of the subtree at top, which must have no parent. Walking towards key,
+* it rotates at every zig-zig or zag-zag step and peels the nodes it passes off into a
+* left tree (keys below key) and a right tree (keys above it). The last node reached,
+* key itself or its neighbour, then takes both as its children and is returned as the
+* subtree's new root.
+*/
+template<typename Key, typename Value>
+Node<Key, Value>* SplayTree<Key, Value>::splay(Node<Key, Value>* top, const Key& key)
+{
+    // the roots of the left and right trees, and where the next node joins each
+    Node<Key, Value>* leftRoot = NULL;
+    Node<Key, Value>* leftMax = NULL;
+    Node<Key, Value>* rightRoot = NULL;
+    Node<Key, Value>* rightMin = NULL;
+
+    Node<Key, Value>* t = top;
+    int depth = 1;
+    while(true)
+    {
+        BST_STATS_VISIT();
+        BST_STATS_DEPTH(depth);
+        BST_STATS_COMPARE(1);
+        if(key < t->getKey())
+        {
+            Node<Key, Value>* child = t->getLeft();
+            if(child == NULL) break;
+            if(key < child->getKey())
+            {
+                // zig-zig: rotate right at t
+                t->setLeft(child->getRight());
+                if(child->getRight() != NULL) child->getRight()->setParent(t);
+                child->setRight(t);
+                t->setParent(child);
+                t = child;
+                BST_STATS_COUNT(singleRotations);
+                if(t->getLeft() == NULL) break;
+            }
+            if(rightMin == NULL) rightRoot = t;
+            else
+            {
+                rightMin->setLeft(t);
+                t->setParent(rightMin);
+            }
+            rightMin = t;
+            t = t->getLeft();
+        }
+        else if(t->getKey() < key)
+        {
+            Node<Key, Value>* child = t->getRight();
+            if(child == NULL) break;
+            if(child->getKey() < key)
+            {
+                // zag-zag: rotate left at t
+                t->setRight(child->getLeft());
+                if(child->getLeft() != NULL) child->getLeft()->setParent(t);
+                child->setLeft(t);
+                t->setParent(child);
+                t = child;
+                BST_STATS_COUNT(singleRotations);
+                if(t->getRight() == NULL) break;
+            }
+            if(leftMax == NULL) leftRoot = t;
+            else
+            {
+                leftMax->setRight(t);
+                t->setParent(leftMax);
+            }
+            leftMax = t;
+            t = t->getRight();
+        }
+        else
+        {
+            break;
+        }
+        ++depth;
+    }
+
+    // t's subtrees fill the gaps at the inner edges of the side trees
+    if(leftMax != NULL)
+    {
+        leftMax->setRight(t->getLeft());
+        if(t->getLeft() != NULL) t->getLeft()->setParent(leftMax);
+        t->setLeft(leftRoot);
+        leftRoot->setParent(t);
+    }
+    if(rightMin != NULL)
+    {
+        rightMin->setLeft(t->getRight());
+        if(t->getRight() != NULL) t->getRight()->setParent(rightMin);
+        t->setRight(rightRoot);
+        rightRoot->setParent(t);
+    }
+    t->setParent(NULL);
+    return t;
+}
+
+/*
+--------------------------------------------------------------
+End implementations for the SplayTree class.
+--------------------------------------------------------------
+*/
+
+#endif
@@ -0,0 +1,193 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <chrono>
+#include <stdexcept>
+#include <cstdint>
+#include "bench_utils.h"
+#include "bst_trace.h"
+#include "bst.h"
+#include "avlbst.h"
+#include "splay_tree.h"
+#include "rbbst.h"
+#include "wavlbst.h"
+#include "compact_avl.h"
+#include "path_avl.h"
+
+using namespace std;
+
+// Replays an operation trace (see bst_trace.h) against a tree implementation.
+//
+// usage: trace-replay <trace> [--tree=bst|avl|wavl|rb|splay|map|compact|path]
+//
+// Traces come from bench --trace or any tree with a TraceWriter attached. The key type
+// is taken from the trace header; values are the index of the inserting record. Prints
+// one JSON object: per-operation counts and latency, and the final size and height.
+
+enum ReplayOp { REPLAY_INSERT = 0, REPLAY_REMOVE, REPLAY_FIND, REPLAY_BEGIN, REPLAY_NEXT, NUM_REPLAY_OPS };
+static const char* REPLAY_NAMES[NUM_REPLAY_OPS] = { "insert", "remove", "find", "begin", "next" };
+
+// height of the final tree, or -1 where the tree does not report one
+template<typename Key, typename Value>
+static int shapeHeight(const BinarySearchTree<Key, Value>& tree)
+{
+	return tree.stats().height;
+}
+
+template<typename Key, typename Value>
+static int shapeHeight(const StdMapAdapter<Key, Value>&)
+{
+	return -1;
+}
+
+template<typename Key, typename Value>
+static int shapeHeight(const CompactAVLTree<Key, Value>&)
+{
+	return -1;
+}
+
+template<typename Key, typename Value>
+static int shapeHeight(const PathAVLTree<Key, Value>&)
+{
+	return -1;
+}
+
+template<typename Tree, typename Key>
+static void replay(const string& path, const string& treeName)
+{
+	TraceReader<Key> reader(path);
+	Tree tree;
+	typename Tree::iterator it = tree.end();
+	LatencyHistogram latency[NUM_REPLAY_OPS];
+	uint64_t records = 0, steps = 0, hits = 0;
+
+	TraceOp op;
+	Key key;
+	uint64_t count;
+	Stopwatch wall;
+	while(reader.next(op, key, count))
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		ReplayOp kind;
+		switch(op)
+		{
+		case TRACE_INSERT:
+			kind = REPLAY_INSERT;
+			tree.insert(make_pair(key, (uint64_t)records));
+			// the iterator may point at a node that moved or went away
+			it = tree.end();
+			break;
+		case TRACE_REMOVE:
+			kind = REPLAY_REMOVE;
+			tree.remove(key);
+			it = tree.end();
+			break;
+		case TRACE_FIND:
+			kind = REPLAY_FIND;
+			it = tree.find(key);
+			if(it != tree.end()) hits++;
+			break;
+		case TRACE_BEGIN:
+			kind = REPLAY_BEGIN;
+			it = tree.begin();
+			break;
+		default:
+			kind = REPLAY_NEXT;
+			// a trace from another tree may step past what this one holds
+			for(uint64_t n = 0; n < count && it != tree.end(); n++, ++it)
+				steps++;
+			break;
+		}
+		uint64_t ns = (uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+		latency[kind].record(ns);
+		records++;
+	}
+	double secs = wall.seconds();
+
+	uint64_t size = 0;
+	for(typename Tree::iterator i = tree.begin(); i != tree.end(); ++i)
+		size++;
+	int height = shapeHeight(tree);
+
+	ostringstream json;
+	json << "{\"trace\":\"" << path << "\",\"tree\":\"" << treeName << "\",\"records\":" << records
+		<< ",\"seconds\":" << secs << ",\"find_hits\":" << hits << ",\"next_steps\":" << steps
+		<< ",\"ops\":{";
+	bool first = true;
+	for(int k = 0; k < NUM_REPLAY_OPS; k++)
+	{
+		const LatencyHistogram& h = latency[k];
+		if(h.count() == 0) continue;
+		json << (first ? "" : ",") << "\"" << REPLAY_NAMES[k] << "\":{\"count\":" << h.count()
+			<< ",\"p50_ns\":" << h.percentile(0.50) << ",\"p99_ns\":" << h.percentile(0.99)
+			<< ",\"max_ns\":" << h.max() << "}";
+		first = false;
+	}
+	json << "},\"size\":" << size << ",\"height\":";
+	if(height < 0) json << "null";
+	else json << height;
+	json << "}";
+	cout << json.str() << endl;
+}
+
+template<typename Key>
+static bool replayAs(const string& path, const string& treeName)
+{
+	if(treeName == "bst") replay<BinarySearchTree<Key, uint64_t>, Key>(path, treeName);
+	else if(treeName == "avl") replay<AVLTree<Key, uint64_t>, Key>(path, treeName);
+	else if(treeName == "wavl") replay<WAVLTree<Key, uint64_t>, Key>(path, treeName);
+	else if(treeName == "rb") replay<RedBlackTree<Key, uint64_t>, Key>(path, treeName);
+	else if(treeName == "splay") replay<SplayTree<Key, uint64_t>, Key>(path, treeName);
+	else if(treeName == "map") replay<StdMapAdapter<Key, uint64_t>, Key>(path, treeName);
+	else if(treeName == "compact") replay<CompactAVLTree<Key, uint64_t>, Key>(path, treeName);
+	else if(treeName == "path") replay<PathAVLTree<Key, uint64_t>, Key>(path, treeName);
+	else return false;
+	return true;
+}
+
+int main(int argc, char *argv[])
+{
+	string path, treeName = "avl";
+	for(int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if(arg.compare(0, 7, "--tree=") == 0) treeName = arg.substr(7);
+		else if(path.empty() && arg.compare(0, 2, "--") != 0) path = arg;
+		else
+		{
+			cerr << "unknown option " << arg << endl;
+			return 1;
+		}
+	}
+	if(path.empty())
+	{
+		cerr << "usage: " << argv[0] << " <trace> [--tree=bst|avl|wavl|rb|splay|map|compact|path]" << endl;
+		return 1;
+	}
+
+	try
+	{
+		TraceHeader header = readTraceHeader(path);
+		bool known;
+		if(header.keyKind == TRACE_KEY_SIGNED && header.keySize == 4) known = replayAs<int32_t>(path, treeName);
+		else if(header.keyKind == TRACE_KEY_SIGNED && header.keySize == 8) known = replayAs<int64_t>(path, treeName);
+		else if(header.keyKind == TRACE_KEY_UNSIGNED && header.keySize == 4) known = replayAs<uint32_t>(path, treeName);
+		else if(header.keyKind == TRACE_KEY_UNSIGNED && header.keySize == 8) known = replayAs<uint64_t>(path, treeName);
+		else
+		{
+			cerr << path << ": only 32- and 64-bit integer keys can be replayed" << endl;
+			return 1;
+		}
+		if(!known)
+		{
+			cerr << "unknown --tree " << treeName << endl;
+			return 1;
+		}
+	}
+	catch(const runtime_error& e)
+	{
+		cerr << e.what() << endl;
+		return 1;
+	}
+	return 0;
+}
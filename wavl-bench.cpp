@@ -0,0 +1,92 @@
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <cstdlib>
+#include "bench_utils.h"
+#include "bst.h"
+#include "avlbst.h"
+#include "wavlbst.h"
+
+using namespace std;
+
+// WAVLTree against AVLTree under deletion-heavy churn, the way a session store sees it:
+// ids are handed out in increasing order and sessions end in random order.
+//
+// usage: wavl-bench [entries] [rounds]
+//
+// The tree is loaded with entries sessions. Each round then ends a random quarter of
+// the live sessions and opens as many new ones. Build with DEFS=-DBST_STATS to also
+// see how many rotations each remove did.
+
+template<typename Tree>
+static void run(const char* name, size_t n, size_t rounds)
+{
+	Tree tree;
+	mt19937 rng(38);
+	vector<int> live(n);
+	for(size_t i = 0; i < n; i++) live[i] = (int)i;
+	int nextId = (int)n;
+
+	Stopwatch watch;
+	for(size_t i = 0; i < n; i++)
+		tree.insert(make_pair(live[i], (int)i));
+	double insertSecs = watch.seconds();
+	int loadHeight = tree.profile().height;
+	tree.resetStats();
+
+	size_t batch = n / 4;
+	double removeSecs = 0, churnInsertSecs = 0;
+	uint64_t removeRotations = 0;
+	for(size_t r = 0; r < rounds; r++)
+	{
+		// the last batch ids in live are the sessions that end
+		for(size_t i = 0; i < batch; i++)
+			swap(live[live.size() - 1 - i], live[rng() % (live.size() - i)]);
+
+		TreeStats before = tree.stats();
+		watch.restart();
+		for(size_t i = live.size() - batch; i < live.size(); i++)
+			tree.remove(live[i]);
+		removeSecs += watch.seconds();
+		TreeStats after = tree.stats();
+		removeRotations += after.singleRotations - before.singleRotations
+			+ 2 * (after.doubleRotations - before.doubleRotations);
+
+		watch.restart();
+		for(size_t i = live.size() - batch; i < live.size(); i++)
+		{
+			live[i] = nextId++;
+			tree.insert(make_pair(live[i], (int)i));
+		}
+		churnInsertSecs += watch.seconds();
+	}
+	size_t churnOps = rounds * batch;
+
+	cout << "  " << name << endl;
+	cout << "    load inserts/s:      " << (uint64_t)(n / insertSecs) << endl;
+	cout << "    height after load:   " << loadHeight << endl;
+	cout << "    churn removes/s:     " << (uint64_t)(churnOps / removeSecs) << endl;
+	cout << "    churn inserts/s:     " << (uint64_t)(churnOps / churnInsertSecs) << endl;
+	cout << "    height after churn:  " << tree.profile().height << endl;
+#ifdef BST_STATS
+	cout << "    rotations/remove:    " << (double)removeRotations / churnOps << endl;
+#else
+	(void)removeRotations;
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+	size_t n = argc > 1 ? strtoul(argv[1], NULL, 10) : 1000000;
+	size_t rounds = argc > 2 ? strtoul(argv[2], NULL, 10) : 8;
+	if(n < 4)
+	{
+		cerr << "usage: " << argv[0] << " [entries >= 4] [rounds]" << endl;
+		return 1;
+	}
+
+	run<WAVLTree<int, int> >("WAVLTree<int,int>", n, rounds);
+	run<AVLTree<int, int> >("AVLTree<int,int>", n, rounds);
+	return 0;
+}
@@ -0,0 +1,287 @@
+#ifndef WAVLBST_H
+#define WAVLBST_H
+
+#include <iostream>
+#include <exception>
+#include <cstdlib>
+#include <cstdint>
+#include "avlbst.h"
+
+/**
+* A weak AVL tree (Haeupler, Sen and Tarjan, "Rank-balanced trees"): AVLTree's search,
+* insert and remove, with rebalancing driven by ranks instead of balance factors.
+*
+* Every node has a rank, a NULL child counting as rank -1, and each child's rank is 1
+* or 2 below its parent's; leaves have rank 0. Only the rank differences are stored,
+* one bit per child in the byte AVLNode uses for its balance: bit 0 is set when the
+* left child is 2 below, bit 1 when the right one is.
+*
+* With inserts only, ranks are heights and the tree is exactly the AVL tree AVLTree
+* would build. Removes do not restore AVL balance (the height stays below 2 log n);
+* in exchange they rotate at most twice and demote O(1) nodes amortized, instead of
+* the rebalancing cascades AVL removal can set off.
+*/
+template <class Key, class Value>
+class WAVLTree : public AVLTree<Key, Value>
+{
+protected:
+    virtual void insertFix(AVLNode<Key, Value>* n) override;
+    virtual void removeFix(AVLNode<Key, Value>* n, int8_t diff) override;
+    // the balance byte holds rank differences, so let the exporters use heights
+    virtual bool nodeBalance(const Node<Key, Value>* n, int& balance) const override;
+    virtual void setChildHeights(AVLNode<Key, Value>* n, int leftHeight, int rightHeight) override;
+
+    // side 0 is the left child, side 1 the right one
+    static int rankDiff(const AVLNode<Key, Value>* n, int side);
+    static void setRankDiff(AVLNode<Key, Value>* n, int side, int diff);
+    static AVLNode<Key, Value>* child(const AVLNode<Key, Value>* n, int side);
+    static int sideOf(const AVLNode<Key, Value>* parent, const AVLNode<Key, Value>* n);
+    // rotates n's child on the given side up into n's place
+    void rotateUp(AVLNode<Key, Value>* n, int side);
+};
+
+/*
+  -----------------------------------------------
+  Begin implementations for the WAVLTree class.
+  -----------------------------------------------
+*/
+
+/**
+* The new leaf n has rank 0. If that ties it with its parent, walk up promoting
+* parents whose other child is a 1-child; the first parent whose other child is a
+* 2-child is fixed with one or two rotations.
+*/
+template<class Key, class Value>
+void WAVLTree<Key, Value>::insertFix(AVLNode<Key, Value>* n)
+{
+    AVLNode<Key, Value>* x = n;
+    AVLNode<Key, Value>* p = x->getParent();
+    if(p == NULL) return;
+    int s = sideOf(p, x);
+    if(rankDiff(p, s) == 2)
+    {
+        // p had rank 1 and a single leaf child
+        setRankDiff(p, s, 1);
+        return;
+    }
+
+    // x has the same rank as p
+    while(true)
+    {
+        int t = 1 - s;
+        if(rankDiff(p, t) == 1)
+        {
+            // promote p
+            setRankDiff(p, s, 1);
+            setRankDiff(p, t, 2);
+            AVLNode<Key, Value>* g = p->getParent();
+            if(g == NULL) return;
+            int gs = sideOf(g, p);
+            if(rankDiff(g, gs) == 2)
+            {
+                setRankDiff(g, gs, 1);
+                return;
+            }
+            x = p;
+            p = g;
+            s = gs;
+            continue;
+        }
+
+        // x was just promoted, so it is a 1,2 node
+        AVLNode<Key, Value>* inner = child(x, t);
+        if(rankDiff(x, t) == 2)
+        {
+            BST_STATS_COUNT(singleRotations);
+            rotateUp(p, s);
+            setRankDiff(x, 0, 1);
+            setRankDiff(x, 1, 1);
+            setRankDiff(p, 0, 1);
+            setRankDiff(p, 1, 1);
+        }
+        else
+        {
+            BST_STATS_COUNT(doubleRotations);
+            int innerS = rankDiff(inner, s);
+            int innerT = rankDiff(inner, t);
+            rotateUp(x, t);
+            rotateUp(p, s);
+            setRankDiff(inner, 0, 1);
+            setRankDiff(inner, 1, 1);
+            setRankDiff(x, s, 1);
+            setRankDiff(x, t, innerS);
+            setRankDiff(p, s, innerT);
+            setRankDiff(p, t, 1);
+        }
+        return;
+    }
+}
+
+/**
+* The child on one side of n (diff is +1 for the left, -1 for the right, as in
+* AVLTree::removeFix) has just lost a rank. Walk up demoting while that leaves a
+* 3-child; rotations end the walk.
+*/
+template<class Key, class Value>
+void WAVLTree<Key, Value>::removeFix(AVLNode<Key, Value>* n, int8_t diff)
+{
+    AVLNode<Key, Value>* p = n;
+    if(p == NULL) return;
+    int s = diff > 0 ? 0 : 1;
+
+    if(rankDiff(p, s) == 1)
+    {
+        setRankDiff(p, s, 2);
+        if(p->getLeft() != NULL || p->getRight() != NULL) return;
+
+        // a leaf of rank 1 is not allowed: demote p to 0
+        setRankDiff(p, 0, 1);
+        setRankDiff(p, 1, 1);
+        AVLNode<Key, Value>* g = p->getParent();
+        if(g == NULL) return;
+        s = sideOf(g, p);
+        p = g;
+        if(rankDiff(p, s) == 1)
+        {
+            setRankDiff(p, s, 2);
+            return;
+        }
+    }
+
+    // p's child on side s is now 3 below it
+    while(true)
+    {
+        int t = 1 - s;
+        AVLNode<Key, Value>* y = child(p, t);
+        if(rankDiff(p, t) == 2)
+        {
+            // demote p
+            setRankDiff(p, s, 2);
+            setRankDiff(p, t, 1);
+        }
+        else if(rankDiff(y, 0) == 2 && rankDiff(y, 1) == 2)
+        {
+            // demote p and y
+            setRankDiff(y, 0, 1);
+            setRankDiff(y, 1, 1);
+            setRankDiff(p, s, 2);
+            setRankDiff(p, t, 1);
+        }
+        else
+        {
+            break;
+        }
+
+        AVLNode<Key, Value>* g = p->getParent();
+        if(g == NULL) return;
+        int gs = sideOf(g, p);
+        if(rankDiff(g, gs) == 1)
+        {
+            setRankDiff(g, gs, 2);
+            return;
+        }
+        p = g;
+        s = gs;
+    }
+
+    // the sibling y is a 1-child with a 1-child of its own: rotate it up
+    int t = 1 - s;
+    AVLNode<Key, Value>* y = child(p, t);
+    if(rankDiff(y, t) == 1)
+    {
+        BST_STATS_COUNT(singleRotations);
+        int innerDiff = rankDiff(y, s);
+        rotateUp(p, t);
+        // y takes p's rank, p drops one
+        setRankDiff(y, s, 1);
+        setRankDiff(y, t, 2);
+        setRankDiff(p, s, 2);
+        setRankDiff(p, t, innerDiff);
+        if(p->getLeft() == NULL && p->getRight() == NULL)
+        {
+            // and one more, rather than become a leaf of rank 1
+            setRankDiff(p, 0, 1);
+            setRankDiff(p, 1, 1);
+            setRankDiff(y, s, 2);
+        }
+    }
+    else
+    {
+        BST_STATS_COUNT(doubleRotations);
+        AVLNode<Key, Value>* w = child(y, s);
+        int wS = rankDiff(w, s);
+        int wT = rankDiff(w, t);
+        rotateUp(y, s);
+        rotateUp(p, t);
+        // w takes p's rank, p and y end up two below it
+        setRankDiff(w, 0, 2);
+        setRankDiff(w, 1, 2);
+        setRankDiff(p, s, 1);
+        setRankDiff(p, t, wS);
+        setRankDiff(y, s, wT);
+        setRankDiff(y, t, 1);
+    }
+}
+
+template<class Key, class Value>
+bool WAVLTree<Key, Value>::nodeBalance(const Node<Key, Value>*, int&) const
+{
+    return false;
+}
+
+/**
+* A tree built bottom-up is an AVL tree, so ranks are heights and each child is 1 or 2
+* below.
+*/
+template<class Key, class Value>
+void WAVLTree<Key, Value>::setChildHeights(AVLNode<Key, Value>* n, int leftHeight, int rightHeight)
+{
+    int height = std::max(leftHeight, rightHeight) + 1;
+    n->setBalance(0);
+    setRankDiff(n, 0, height - leftHeight);
+    setRankDiff(n, 1, height - rightHeight);
+}
+
+template<class Key, class Value>
+int WAVLTree<Key, Value>::rankDiff(const AVLNode<Key, Value>* n, int side)
+{
+    return (n->getBalance() >> side) & 1 ? 2 : 1;
+}
+
+template<class Key, class Value>
+void WAVLTree<Key, Value>::setRankDiff(AVLNode<Key, Value>* n, int side, int diff)
+{
+    int8_t bits = n->getBalance() & ~(1 << side);
+    n->setBalance(bits | (diff == 2 ? 1 << side : 0));
+}
+
+template<class Key, class Value>
+AVLNode<Key, Value>* WAVLTree<Key, Value>::child(const AVLNode<Key, Value>* n, int side)
+{
+    return side == 0 ? n->getLeft() : n->getRight();
+}
+
+template<class Key, class Value>
+int WAVLTree<Key, Value>::sideOf(const AVLNode<Key, Value>* parent, const AVLNode<Key, Value>* n)
+{
+    return parent->getLeft() == n ? 0 : 1;
+}
+
+/**
+* Uses AVLTree's rotations for the relinking; the callers overwrite the balance bytes
+* those compute.
+*/
+template<class Key, class Value>
+void WAVLTree<Key, Value>::rotateUp(AVLNode<Key, Value>* n, int side)
+{
+    if(side == 0) this->rotateRight(n);
+    else this->rotateLeft(n);
+}
+
+/*
+  -----------------------------------------------
+  End implementations for the WAVLTree class.
+  -----------------------------------------------
+*/
+
+#endif